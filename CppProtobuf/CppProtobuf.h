@@ -110,6 +110,7 @@ FOUNDATION_EXPORT const unsigned char CppProtobufVersionString[];
 #import <CppProtobuf/google_protobuf_util_field_mask_util.hpp>
 #import <CppProtobuf/google_protobuf_util_json_util.hpp>
 #import <CppProtobuf/google_protobuf_util_message_differencer.hpp>
+#import <CppProtobuf/google_protobuf_util_message_hash.hpp>
 #import <CppProtobuf/google_protobuf_util_time_util.hpp>
 #import <CppProtobuf/google_protobuf_util_type_resolver.hpp>
 #import <CppProtobuf/google_protobuf_util_type_resolver_util.hpp>
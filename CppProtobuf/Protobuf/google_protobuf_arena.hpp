@@ -1303,6 +1303,15 @@ struct ArenaOptions {
   // calls free.
   void (*block_dealloc)(void*, size_t) = nullptr;
 
+  // If true, repeated message and string fields on the arena create new
+  // elements in chunks, back to back, instead of one at a time. Scans over
+  // large repeated fields then touch contiguous memory, and parsing them does
+  // fewer allocations. The elements of a chunk that are not used yet are kept
+  // as cleared elements of the field (see RepeatedPtrField::ClearedCount()).
+  // Chunks have at least 4 elements, so a field may hold up to
+  // max(2 * size, 4) element objects.
+  bool contiguous_repeated_elements = false;
+
  private:
   internal::AllocationPolicy AllocationPolicy() const {
     internal::AllocationPolicy res;
@@ -1379,7 +1388,10 @@ class PROTOBUF_EXPORT PROTOBUF_ALIGNAS(8) Arena final {
   // descriptions of the options available.
   explicit Arena(const ArenaOptions& options)
       : impl_(options.initial_block, options.initial_block_size,
-              options.AllocationPolicy()) {}
+              options.AllocationPolicy()) {
+    impl_.set_contiguous_repeated_elements(
+        options.contiguous_repeated_elements);
+  }
 
   // Block overhead.  Use this as a guide for how much to over-allocate the
   // initial block if you want an allocation of size N to fit inside it.
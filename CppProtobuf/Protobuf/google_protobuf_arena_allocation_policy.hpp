@@ -70,11 +70,19 @@ class TaggedAllocationPolicyPtr {
     set_mask<kUserOwnedInitialBlock>(v);
   }
 
+  bool contiguous_repeated_elements() const {
+    return static_cast<bool>(get_mask<kContiguousRepeatedElements>());
+  }
+  void set_contiguous_repeated_elements(bool v) {
+    set_mask<kContiguousRepeatedElements>(v);
+  }
+
   uintptr_t get_raw() const { return policy_; }
 
  private:
   enum : uintptr_t {
     kUserOwnedInitialBlock = 1,
+    kContiguousRepeatedElements = 2,
   };
 
   static constexpr uintptr_t kTagsMask = 7;
@@ -2530,6 +2530,11 @@ class DescriptorPool::Tables {
   // stack, removing everything that was added after that point.
   void RollbackToLastCheckpoint();
 
+  // Makes room for the given number of files and symbols on top of those
+  // already in the tables, so that building many files at once does not
+  // rehash the tables over and over.
+  void Reserve(size_t file_count, size_t symbol_count);
+
   // The stack of files which are currently being built.  Used to detect
   // cyclic dependencies when loading files from a DescriptorDatabase.  Not
   // used when fallback_database_ == nullptr.
@@ -2748,6 +2753,14 @@ void DescriptorPool::Tables::RollbackToLastCheckpoint() {
   checkpoints_.pop_back();
 }
 
+void DescriptorPool::Tables::Reserve(size_t file_count, size_t symbol_count) {
+  files_by_name_.reserve(files_by_name_.size() + file_count);
+  symbols_by_name_.reserve(symbols_by_name_.size() + symbol_count);
+  files_after_checkpoint_.reserve(files_after_checkpoint_.size() + file_count);
+  symbols_after_checkpoint_.reserve(symbols_after_checkpoint_.size() +
+                                    symbol_count);
+}
+
 // -------------------------------------------------------------------
 
 inline Symbol DescriptorPool::Tables::FindSymbol(absl::string_view key) const {
@@ -5704,6 +5717,42 @@ class DescriptorBuilder {
                       const FieldDescriptorProto& proto);
 };
 
+namespace {
+
+// Counts the symbols that building a file adds to the pool, not counting its
+// package.
+size_t CountSymbols(const EnumDescriptorProto& proto) {
+  return 1 + proto.value_size();
+}
+
+size_t CountSymbols(const DescriptorProto& proto) {
+  size_t count = 1 + proto.field_size() + proto.extension_size() +
+                 proto.oneof_decl_size();
+  for (const DescriptorProto& nested : proto.nested_type()) {
+    count += CountSymbols(nested);
+  }
+  for (const EnumDescriptorProto& nested : proto.enum_type()) {
+    count += CountSymbols(nested);
+  }
+  return count;
+}
+
+size_t CountSymbols(const FileDescriptorProto& proto) {
+  size_t count = proto.extension_size();
+  for (const DescriptorProto& message : proto.message_type()) {
+    count += CountSymbols(message);
+  }
+  for (const EnumDescriptorProto& enum_type : proto.enum_type()) {
+    count += CountSymbols(enum_type);
+  }
+  for (const ServiceDescriptorProto& service : proto.service()) {
+    count += 1 + service.method_size();
+  }
+  return count;
+}
+
+}  // namespace
+
 const FileDescriptor* DescriptorPool::BuildFile(
     const FileDescriptorProto& proto) {
   return BuildFileCollectingErrors(proto, nullptr);
@@ -5723,6 +5772,81 @@ const FileDescriptor* DescriptorPool::BuildFileCollectingErrors(
       ->BuildFile(proto);
 }
 
+std::vector<const FileDescriptor*> DescriptorPool::BuildFiles(
+    const FileDescriptorSet& files) {
+  return BuildFilesCollectingErrors(files, nullptr);
+}
+
+std::vector<const FileDescriptor*> DescriptorPool::BuildFilesCollectingErrors(
+    const FileDescriptorSet& files, ErrorCollector* error_collector) {
+  ABSL_CHECK(fallback_database_ == nullptr)
+      << "Cannot call BuildFiles on a DescriptorPool that uses a "
+         "DescriptorDatabase.  You must instead find a way to get your files "
+         "into the underlying database.";
+  ABSL_CHECK(mutex_ == nullptr);  // Implied by the above ABSL_CHECK.
+  tables_->known_bad_symbols_.clear();
+  tables_->known_bad_files_.clear();
+  build_started_ = true;
+
+  // Order the files so that each one comes after its dependencies in the set.
+  // The traversal is iterative, as dependency chains can be long. Cycles are
+  // left for DescriptorBuilder to report.
+  const int file_count = files.file_size();
+  absl::flat_hash_map<absl::string_view, int> index_by_name;
+  index_by_name.reserve(file_count);
+  for (int i = 0; i < file_count; ++i) {
+    index_by_name.try_emplace(files.file(i).name(), i);
+  }
+  enum : char { kUnvisited, kVisiting, kVisited };
+  std::vector<char> state(file_count, kUnvisited);
+  std::vector<int> build_order;
+  build_order.reserve(file_count);
+  // Pairs of a file index and the position of its next dependency to visit.
+  std::vector<std::pair<int, int>> stack;
+  for (int root = 0; root < file_count; ++root) {
+    if (state[root] != kUnvisited) continue;
+    state[root] = kVisiting;
+    stack.emplace_back(root, 0);
+    while (!stack.empty()) {
+      const int index = stack.back().first;
+      const FileDescriptorProto& proto = files.file(index);
+      if (stack.back().second < proto.dependency_size()) {
+        auto it = index_by_name.find(proto.dependency(stack.back().second++));
+        if (it != index_by_name.end() && state[it->second] == kUnvisited) {
+          state[it->second] = kVisiting;
+          stack.emplace_back(it->second, 0);
+        }
+      } else {
+        state[index] = kVisited;
+        build_order.push_back(index);
+        stack.pop_back();
+      }
+    }
+  }
+
+  size_t symbol_count = 0;
+  for (const FileDescriptorProto& proto : files.file()) {
+    symbol_count += CountSymbols(proto);
+  }
+
+  // The outer checkpoint lets us drop every file built so far if a later one
+  // fails.
+  std::vector<const FileDescriptor*> result(file_count);
+  tables_->AddCheckpoint();
+  tables_->Reserve(file_count, symbol_count);
+  for (int index : build_order) {
+    result[index] =
+        DescriptorBuilder::New(this, tables_.get(), error_collector)
+            ->BuildFile(files.file(index));
+    if (result[index] == nullptr) {
+      tables_->RollbackToLastCheckpoint();
+      return {};
+    }
+  }
+  tables_->ClearLastCheckpoint();
+  return result;
+}
+
 const FileDescriptor* DescriptorPool::BuildFileFromDatabase(
     const FileDescriptorProto& proto) const {
   mutex_->AssertHeld();
@@ -1275,6 +1275,7 @@ class EnumValueDescriptorProto;
 class ServiceDescriptorProto;
 class MethodDescriptorProto;
 class FileDescriptorProto;
+class FileDescriptorSet;
 class MessageOptions;
 class FieldOptions;
 class OneofOptions;
@@ -3439,6 +3440,18 @@ class PROTOBUF_EXPORT DescriptorPool {
   const FileDescriptor* BuildFileCollectingErrors(
       const FileDescriptorProto& proto, ErrorCollector* error_collector);
 
+  // Builds all the files in the set, which may be in any order: each file is
+  // built after those of its dependencies that are also in the set. The other
+  // dependencies must already be in the pool. Either all of the files are
+  // added to the pool or, if any of them fails to build, none are. Returns
+  // the resulting FileDescriptors in the order of the set, or an empty vector
+  // if there were errors.
+  std::vector<const FileDescriptor*> BuildFiles(const FileDescriptorSet& files);
+
+  // Same as BuildFiles() except errors are sent to the given ErrorCollector.
+  std::vector<const FileDescriptor*> BuildFilesCollectingErrors(
+      const FileDescriptorSet& files, ErrorCollector* error_collector);
+
   // By default, it is an error if a FileDescriptorProto contains references
   // to types or other files that are not found in the DescriptorPool (or its
   // backing DescriptorDatabase, if any).  If you call
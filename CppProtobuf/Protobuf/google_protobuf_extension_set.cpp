@@ -11,6 +11,9 @@
 
 #include "google_protobuf_extension_set.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -1246,11 +1249,34 @@ using ExtensionRegistry =
 
 static const ExtensionRegistry* global_registry = nullptr;
 
+// Bumped by every registration. Inserting may move the registry's elements,
+// so lookup caches filled under an older generation are dropped.
+static std::atomic<uint32_t> registry_generation{0};
+
+// Per-thread, direct-mapped cache in front of the registry. Parsing messages
+// with many extensions looks up the same (extendee, number) pairs over and
+// over; the cache answers those, misses included, without hashing into the
+// registry. Consecutive numbers of one extendee land in consecutive slots.
+struct RegistryCache {
+  struct Entry {
+    const MessageLite* extendee;
+    int number;
+    const ExtensionInfo* info;
+  };
+  static constexpr uint32_t kSize = 256;
+
+  uint32_t generation;
+  Entry entries[kSize];
+};
+
+PROTOBUF_CONSTINIT PROTOBUF_THREAD_LOCAL RegistryCache registry_cache;
+
 // This function is only called at startup, so there is no need for thread-
 // safety.
 void Register(const ExtensionInfo& info) {
   static auto local_static_registry = OnShutdownDelete(new ExtensionRegistry);
   global_registry = local_static_registry;
+  registry_generation.fetch_add(1, std::memory_order_relaxed);
   if (!local_static_registry->insert(info).second) {
     ABSL_LOG(FATAL) << "Multiple extension registrations for type \""
                     << info.message->GetTypeName() << "\", field number "
@@ -1262,16 +1288,30 @@ const ExtensionInfo* FindRegisteredExtension(const MessageLite* extendee,
                                              int number) {
   if (!global_registry) return nullptr;
 
+  RegistryCache& cache = registry_cache;
+  const uint32_t generation =
+      registry_generation.load(std::memory_order_relaxed);
+  if (PROTOBUF_PREDICT_FALSE(cache.generation != generation)) {
+    std::fill(std::begin(cache.entries), std::end(cache.entries),
+              RegistryCache::Entry{});
+    cache.generation = generation;
+  }
+  RegistryCache::Entry& entry =
+      cache.entries[(static_cast<uint32_t>(number) +
+                     static_cast<uint32_t>(
+                         reinterpret_cast<uintptr_t>(extendee) >> 3)) &
+                    (RegistryCache::kSize - 1)];
+  if (entry.extendee == extendee && entry.number == number) {
+    return entry.info;
+  }
+
   ExtensionInfo info;
   info.message = extendee;
   info.number = number;
 
   auto it = global_registry->find(info);
-  if (it == global_registry->end()) {
-    return nullptr;
-  } else {
-    return &*it;
-  }
+  entry = {extendee, number, it == global_registry->end() ? nullptr : &*it};
+  return entry.info;
 }
 
 }  // namespace
@@ -2750,14 +2790,36 @@ const ExtensionSet::Extension* ExtensionSet::FindOrNull(int key) const {
   if (flat_size_ == 0) {
     return nullptr;
   } else if (PROTOBUF_PREDICT_TRUE(!is_large())) {
-    auto it = std::lower_bound(flat_begin(), flat_end() - 1, key,
-                               KeyValue::FirstComparator());
-    return it->first == key ? &it->second : nullptr;
+    const KeyValue* it = FlatLowerBound(key);
+    return it != flat_end() && it->first == key ? &it->second : nullptr;
   } else {
     return FindOrNullInLargeMap(key);
   }
 }
 
+const ExtensionSet::KeyValue* ExtensionSet::FlatLowerBound(int key) const {
+  const KeyValue* begin = flat_begin();
+  const KeyValue* end = flat_end();
+  if (begin == end || key <= begin->first) return begin;
+  if (key > end[-1].first) return end;
+  // Numbers are unique and sorted, so the entry at index i is at least i above
+  // the first number and at least (size - 1 - i) below the last one. That
+  // narrows the search to as many entries as there are gaps between the
+  // numbers: a dense run of extensions is indexed directly, and clustered
+  // numbers only need a few probes.
+  const int64_t size = end - begin;
+  const int64_t hi = std::min<int64_t>(size, int64_t{key} - begin->first + 1);
+  const int64_t lo =
+      std::max<int64_t>(0, int64_t{key} - end[-1].first + size - 1);
+  return std::lower_bound(begin + lo, begin + hi, key,
+                          KeyValue::FirstComparator());
+}
+
+ExtensionSet::KeyValue* ExtensionSet::FlatLowerBound(int key) {
+  const auto* const_this = this;
+  return const_cast<ExtensionSet::KeyValue*>(const_this->FlatLowerBound(key));
+}
+
 const ExtensionSet::Extension* ExtensionSet::FindOrNullInLargeMap(
     int key) const {
   assert(is_large());
@@ -2785,8 +2847,7 @@ std::pair<ExtensionSet::Extension*, bool> ExtensionSet::Insert(int key) {
     return {&maybe.first->second, maybe.second};
   }
   KeyValue* end = flat_end();
-  KeyValue* it =
-      std::lower_bound(flat_begin(), end, key, KeyValue::FirstComparator());
+  KeyValue* it = FlatLowerBound(key);
   if (it != end && it->first == key) {
     return {&it->second, false};
   }
@@ -2850,8 +2911,7 @@ void ExtensionSet::Erase(int key) {
     return;
   }
   KeyValue* end = flat_end();
-  KeyValue* it =
-      std::lower_bound(flat_begin(), end, key, KeyValue::FirstComparator());
+  KeyValue* it = FlatLowerBound(key);
   if (it != end && it->first == key) {
     std::copy(it + 1, end, it);
     --flat_size_;
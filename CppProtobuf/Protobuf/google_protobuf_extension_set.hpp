@@ -1869,6 +1869,10 @@ class PROTOBUF_EXPORT ExtensionSet {
   const Extension* FindOrNull(int key) const;
   Extension* FindOrNull(int key);
 
+  // Returns the first flat-map entry whose number is not less than key.
+  const KeyValue* FlatLowerBound(int key) const;
+  KeyValue* FlatLowerBound(int key);
+
   // Helper-functions that only inspect the LargeMap.
   const Extension* FindOrNullInLargeMap(int key) const;
   Extension* FindOrNullInLargeMap(int key);
@@ -1880,8 +1884,10 @@ class PROTOBUF_EXPORT ExtensionSet {
 
   // Grows the flat_capacity_.
   // If flat_capacity_ > kMaximumFlatCapacity, converts to LargeMap.
+  // FlatLowerBound() keeps lookups into a large flat map cheap, and extensions
+  // usually arrive in order while parsing, so inserting stays an append.
   void GrowCapacity(size_t minimum_new_capacity);
-  static constexpr uint16_t kMaximumFlatCapacity = 256;
+  static constexpr uint16_t kMaximumFlatCapacity = 1024;
   bool is_large() const { return static_cast<int16_t>(flat_size_) < 0; }
 
   // Removes a key from the ExtensionSet.
@@ -3824,6 +3824,53 @@ const FieldDescriptor* Reflection::FindKnownExtensionByNumber(
   return descriptor_pool_->FindExtensionByNumber(descriptor_, number);
 }
 
+FieldAccessor Reflection::GetFieldAccessor(
+    const FieldDescriptor* field) const {
+  USAGE_CHECK_MESSAGE_TYPE(GetFieldAccessor);
+  USAGE_CHECK_SINGULAR(GetFieldAccessor);
+  USAGE_CHECK_NE(field->cpp_type(), FieldDescriptor::CPPTYPE_MESSAGE,
+                 GetFieldAccessor, "Field is a message field.");
+
+  FieldAccessor accessor(this, field);
+  if (field->is_extension() || schema_.IsSplit(field)) return accessor;
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_STRING:
+      if (internal::cpp::EffectiveStringCType(field) == FieldOptions::CORD ||
+          IsInlined(field)) {
+        return accessor;
+      }
+      accessor.value_size_ = 0;
+      break;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      accessor.value_size_ = sizeof(bool);
+      break;
+    case FieldDescriptor::CPPTYPE_INT64:
+    case FieldDescriptor::CPPTYPE_UINT64:
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      accessor.value_size_ = sizeof(uint64_t);
+      break;
+    default:
+      accessor.value_size_ = sizeof(uint32_t);
+      break;
+  }
+  accessor.direct_ = true;
+  accessor.closed_enum_ =
+      field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM &&
+      !internal::CreateUnknownEnumValues(field);
+  accessor.offset_ = schema_.GetFieldOffset(field);
+  accessor.number_ = static_cast<uint32_t>(field->number());
+  if (schema_.InRealOneof(field)) {
+    accessor.oneof_case_offset_ =
+        schema_.GetOneofCaseOffset(field->containing_oneof());
+  } else if (schema_.HasBitIndex(field) != static_cast<uint32_t>(-1)) {
+    const uint32_t index = schema_.HasBitIndex(field);
+    accessor.has_bit_offset_ = static_cast<uint32_t>(
+        schema_.HasBitsOffset() + index / 32 * sizeof(uint32_t));
+    accessor.has_bit_mask_ = static_cast<uint32_t>(1) << (index % 32);
+  }
+  return accessor;
+}
+
 bool Reflection::SupportsUnknownEnumValues() const {
   return FileDescriptorLegacy(descriptor_->file()).syntax() ==
          FileDescriptorLegacy::Syntax::SYNTAX_PROTO3;
@@ -2025,6 +2025,18 @@ class PROTOBUF_EXPORT TcParser final {
   PROTOBUF_NOINLINE
   static void DestroyMapNode(NodeBase* node, MapAuxInfo map_info,
                              UntypedMapBase& map);
+  static void ReserveMap(UntypedMapBase& map, MapTypeCard key_type_card,
+                         size_t n);
+
+  // Reserve room in `field` for the run of elements that starts at `ptr`, when
+  // the parse asks for it (see ParseContext::Data::presize_repeated_fields).
+  // `ptr` points just past the first tag, or at the length of a packed field.
+  template <typename FieldType>
+  static void PresizeRepeatedField(FieldType& field, const char* ptr,
+                                   uint32_t tag, ParseContext* ctx);
+  template <typename FieldType>
+  static void PresizePackedVarintField(FieldType& field, const char* ptr,
+                                       ParseContext* ctx);
   static const char* ParseOneMapEntry(NodeBase* node, const char* ptr,
                                       ParseContext* ctx,
                                       const TcParseTableBase::FieldAux* aux,
@@ -1290,6 +1290,22 @@ static uint32_t FastDecodeTag(uint16_t coded_tag) {
   return result >> 1;
 }
 
+template <typename FieldType>
+void TcParser::PresizeRepeatedField(FieldType& field, const char* ptr,
+                                    uint32_t tag, ParseContext* ctx) {
+  if (PROTOBUF_PREDICT_TRUE(!ctx->data().presize_repeated_fields)) return;
+  const int n = ctx->CountFieldRun(ptr, tag);
+  if (n > 1) field.Reserve(field.size() + n);
+}
+
+template <typename FieldType>
+void TcParser::PresizePackedVarintField(FieldType& field, const char* ptr,
+                                        ParseContext* ctx) {
+  if (PROTOBUF_PREDICT_TRUE(!ctx->data().presize_repeated_fields)) return;
+  const int n = ctx->CountPackedVarints(ptr);
+  if (n > 1) field.Reserve(field.size() + n);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // Core mini parsing implementation:
 //////////////////////////////////////////////////////////////////////////////
@@ -1650,6 +1666,8 @@ inline PROTOBUF_ALWAYS_INLINE const char* TcParser::RepeatedParseMessageAuxImpl(
   auto& field = RefAt<RepeatedPtrFieldBase>(msg, data.offset());
   const MessageLite* const default_instance =
       aux_is_table ? aux.table->default_instance : aux.message_default();
+  PresizeRepeatedField(field, ptr + sizeof(TagType),
+                       FastDecodeTag(expected_tag), ctx);
   do {
     ptr += sizeof(TagType);
     MessageLite* submsg =
@@ -1761,6 +1779,7 @@ PROTOBUF_ALWAYS_INLINE const char* TcParser::RepeatedFixed(
   }
   auto& field = RefAt<RepeatedField<LayoutType>>(msg, data.offset());
   const auto tag = UnalignedLoad<TagType>(ptr);
+  PresizeRepeatedField(field, ptr + sizeof(TagType), FastDecodeTag(tag), ctx);
   do {
     field.Add(UnalignedLoad<LayoutType>(ptr + sizeof(TagType)));
     ptr += sizeof(TagType) + sizeof(LayoutType);
@@ -2099,6 +2118,8 @@ PROTOBUF_ALWAYS_INLINE const char* TcParser::RepeatedVarint(
   }
   auto& field = RefAt<RepeatedField<FieldType>>(msg, data.offset());
   const auto expected_tag = UnalignedLoad<TagType>(ptr);
+  PresizeRepeatedField(field, ptr + sizeof(TagType),
+                       FastDecodeTag(expected_tag), ctx);
   do {
     ptr += sizeof(TagType);
     FieldType tmp;
@@ -2167,6 +2188,7 @@ PROTOBUF_ALWAYS_INLINE const char* TcParser::PackedVarint(
   // pending hasbits now:
   SyncHasbits(msg, hasbits, table);
   auto* field = &RefAt<RepeatedField<FieldType>>(msg, data.offset());
+  PresizePackedVarintField(*field, ptr, ctx);
   return ctx->ReadPackedVarint(ptr, [field](uint64_t varint) {
     FieldType val;
     if (zigzag) {
@@ -2720,6 +2742,8 @@ PROTOBUF_ALWAYS_INLINE const char* TcParser::RepeatedString(
   }
   const auto expected_tag = UnalignedLoad<TagType>(ptr);
   auto& field = RefAt<FieldType>(msg, data.offset());
+  PresizeRepeatedField(field, ptr + sizeof(TagType),
+                       FastDecodeTag(expected_tag), ctx);
 
   const auto validate_last_string = [expected_tag, table, &field] {
     switch (utf8) {
@@ -2965,6 +2989,7 @@ PROTOBUF_NOINLINE const char* TcParser::MpRepeatedFixed(
     }
     auto& field = MaybeCreateRepeatedFieldRefAt<uint64_t, is_split>(
         base, entry.offset, msg);
+    PresizeRepeatedField(field, ptr, decoded_tag, ctx);
     constexpr auto size = sizeof(uint64_t);
     const char* ptr2 = ptr;
     uint32_t next_tag;
@@ -2983,6 +3008,7 @@ PROTOBUF_NOINLINE const char* TcParser::MpRepeatedFixed(
     }
     auto& field = MaybeCreateRepeatedFieldRefAt<uint32_t, is_split>(
         base, entry.offset, msg);
+    PresizeRepeatedField(field, ptr, decoded_tag, ctx);
     constexpr auto size = sizeof(uint32_t);
     const char* ptr2 = ptr;
     uint32_t next_tag;
@@ -3114,6 +3140,7 @@ const char* TcParser::MpRepeatedVarintT(PROTOBUF_TC_PARAM_DECL) {
   void* const base = MaybeGetSplitBase(msg, is_split, table);
   auto& field = MaybeCreateRepeatedFieldRefAt<FieldType, is_split>(
       base, entry.offset, msg);
+  PresizeRepeatedField(field, ptr, decoded_tag, ctx);
 
   TcParseTableBase::FieldAux aux;
   if (is_validated_enum) {
@@ -3232,6 +3259,7 @@ const char* TcParser::MpPackedVarintT(PROTOBUF_TC_PARAM_DECL) {
       }
     });
   } else {
+    PresizePackedVarintField(*field, ptr, ctx);
     return ctx->ReadPackedVarint(ptr, [=](uint64_t value) {
       field->Add(is_zigzag ? (sizeof(FieldType) == 8
                                   ? WireFormatLite::ZigZagDecode64(value)
@@ -3439,6 +3467,7 @@ PROTOBUF_NOINLINE const char* TcParser::MpRepeatedString(
     case field_layout::kRepSString: {
       auto& field = MaybeCreateRepeatedPtrFieldRefAt<std::string, is_split>(
           base, entry.offset, msg);
+      PresizeRepeatedField(field, ptr, decoded_tag, ctx);
       const char* ptr2 = ptr;
       uint32_t next_tag;
 
@@ -3601,6 +3630,7 @@ const char* TcParser::MpRepeatedMessageOrGroup(PROTOBUF_TC_PARAM_DECL) {
   RepeatedPtrFieldBase& field =
       MaybeCreateRepeatedRefAt<RepeatedPtrFieldBase, is_split>(
           base, entry.offset, msg);
+  PresizeRepeatedField(field, ptr, decoded_tag, ctx);
   const auto aux = *table->field_aux(&entry);
   if ((type_card & field_layout::kTvMask) == field_layout::kTvTable) {
     auto* inner_table = aux.table;
@@ -3771,6 +3801,26 @@ PROTOBUF_NOINLINE void TcParser::DestroyMapNode(NodeBase* node,
   map.DeallocNode(node, map_info.node_size_info);
 }
 
+void TcParser::ReserveMap(UntypedMapBase& map, MapTypeCard key_type_card,
+                          size_t n) {
+  switch (key_type_card.cpp_type()) {
+    case MapTypeCard::kBool:
+      static_cast<KeyMapBase<bool>&>(map).Reserve(n);
+      break;
+    case MapTypeCard::k32:
+      static_cast<KeyMapBase<uint32_t>&>(map).Reserve(n);
+      break;
+    case MapTypeCard::k64:
+      static_cast<KeyMapBase<uint64_t>&>(map).Reserve(n);
+      break;
+    case MapTypeCard::kString:
+      static_cast<KeyMapBase<std::string>&>(map).Reserve(n);
+      break;
+    default:
+      PROTOBUF_ASSUME(false);
+  }
+}
+
 template <typename T>
 const char* ReadFixed(void* obj, const char* ptr) {
   auto v = UnalignedLoad<T>(ptr);
@@ -3915,6 +3965,12 @@ PROTOBUF_NOINLINE const char* TcParser::MpMap(PROTOBUF_TC_PARAM_DECL) {
 
   const uint32_t saved_tag = data.tag();
 
+  // Presize the table; see CountFieldRun().
+  const int num_entries = ctx->CountFieldRun(ptr, saved_tag);
+  if (num_entries > 1) {
+    ReserveMap(map, map_info.key_type_card, map.size() + num_entries);
+  }
+
   while (true) {
     NodeBase* node = map.AllocNode(map_info.node_size_info);
 
@@ -1364,6 +1364,11 @@ inline void OnShutdownDestroyString(const std::string* ptr) {
 
 // Helpers for deterministic serialization =============================
 
+struct NodeBase;
+
+// Returns the key of a map node. Defined in map.h, where NodeBase is complete.
+inline const void* GetMapNodeKey(const NodeBase* node);
+
 // Iterator base for MapSorterFlat and MapSorterPtr.
 template <typename storage_type>
 struct MapSorterIt {
@@ -1383,119 +1388,60 @@ struct MapSorterIt {
   MapSorterIt operator+(int v) { return MapSorterIt{ptr + v}; }
 };
 
-// Defined outside of MapSorterFlat to only be templatized on the key.
-template <typename KeyT>
-struct MapSorterLessThan {
-  using storage_type = std::pair<KeyT, const void*>;
-  bool operator()(const storage_type& a, const storage_type& b) const {
-    return a.first < b.first;
-  }
-};
-
-// MapSorterFlat stores keys inline with pointers to map entries, so that
-// keys can be compared without indirection. This type is used for maps with
-// keys that are not strings.
+// Shared implementation of MapSorterFlat and MapSorterPtr. The map sorts its
+// nodes on first use and keeps the order until the next insert or erase, so
+// serializing an unchanged map again does not sort it again.
 template <typename MapT>
-class MapSorterFlat {
+class MapSorterBase {
  public:
   using value_type = typename MapT::value_type;
-  // To avoid code bloat we don't put `value_type` in `storage_type`. It is not
-  // necessary for the call to sort, and avoiding it prevents unnecessary
-  // separate instantiations of sort.
-  using storage_type = std::pair<typename MapT::key_type, const void*>;
-
-  // This const_iterator dereferenes to the map entry stored in the sorting
-  // array pairs. This is the same interface as the Map::const_iterator type,
-  // and allows generated code to use the same loop body with either form:
+  using storage_type = NodeBase* const;
+
+  // This const_iterator dereferences the map node stored in the sorted array.
+  // This is the same interface as the Map::const_iterator type, and allows
+  // generated code to use the same loop body with either form:
   //   for (const auto& entry : map) { ... }
-  //   for (const auto& entry : MapSorterFlat(map)) { ... }
+  //   for (const auto& entry : MapSorterPtr(map)) { ... }
   struct const_iterator : public MapSorterIt<storage_type> {
     using pointer = const typename MapT::value_type*;
     using reference = const typename MapT::value_type&;
     using MapSorterIt<storage_type>::MapSorterIt;
 
     pointer operator->() const {
-      return static_cast<const value_type*>(this->ptr->second);
+      // The entry starts where the node's key does.
+      return static_cast<pointer>(GetMapNodeKey(*this->ptr));
     }
     reference operator*() const { return *this->operator->(); }
   };
 
-  explicit MapSorterFlat(const MapT& m)
-      : size_(m.size()), items_(size_ ? new storage_type[size_] : nullptr) {
-    if (!size_) return;
-    storage_type* it = &items_[0];
-    for (const auto& entry : m) {
-      *it++ = {entry.first, &entry};
-    }
-    std::sort(&items_[0], &items_[size_],
-              MapSorterLessThan<typename MapT::key_type>{});
-  }
   size_t size() const { return size_; }
-  const_iterator begin() const { return {items_.get()}; }
-  const_iterator end() const { return {items_.get() + size_}; }
+  const_iterator begin() const { return {items_}; }
+  const_iterator end() const { return {items_ + size_}; }
+
+ protected:
+  explicit MapSorterBase(const MapT& m)
+      : size_(m.size()), items_(m.SortedNodes()) {
+    static_assert(PROTOBUF_FIELD_OFFSET(typename MapT::value_type, first) == 0,
+                  "The entry must start with its key.");
+  }
 
  private:
   size_t size_;
-  std::unique_ptr<storage_type[]> items_;
+  NodeBase* const* items_;
 };
 
-// Defined outside of MapSorterPtr to only be templatized on the key.
-template <typename KeyT>
-struct MapSorterPtrLessThan {
-  bool operator()(const void* a, const void* b) const {
-    // The pointers point to the `std::pair<const Key, Value>` object.
-    // We cast directly to the key to read it.
-    return *reinterpret_cast<const KeyT*>(a) <
-           *reinterpret_cast<const KeyT*>(b);
-  }
+// Iterates a map with keys that are not strings in key order.
+template <typename MapT>
+class MapSorterFlat : public MapSorterBase<MapT> {
+ public:
+  explicit MapSorterFlat(const MapT& m) : MapSorterBase<MapT>(m) {}
 };
 
-// MapSorterPtr stores and sorts pointers to map entries. This type is used for
-// maps with keys that are strings.
+// Iterates a map with keys that are strings in key order.
 template <typename MapT>
-class MapSorterPtr {
+class MapSorterPtr : public MapSorterBase<MapT> {
  public:
-  using value_type = typename MapT::value_type;
-  // To avoid code bloat we don't put `value_type` in `storage_type`. It is not
-  // necessary for the call to sort, and avoiding it prevents unnecessary
-  // separate instantiations of sort.
-  using storage_type = const void*;
-
-  // This const_iterator dereferenes the map entry pointer stored in the sorting
-  // array. This is the same interface as the Map::const_iterator type, and
-  // allows generated code to use the same loop body with either form:
-  //   for (const auto& entry : map) { ... }
-  //   for (const auto& entry : MapSorterPtr(map)) { ... }
-  struct const_iterator : public MapSorterIt<storage_type> {
-    using pointer = const typename MapT::value_type*;
-    using reference = const typename MapT::value_type&;
-    using MapSorterIt<storage_type>::MapSorterIt;
-
-    pointer operator->() const {
-      return static_cast<const value_type*>(*this->ptr);
-    }
-    reference operator*() const { return *this->operator->(); }
-  };
-
-  explicit MapSorterPtr(const MapT& m)
-      : size_(m.size()), items_(size_ ? new storage_type[size_] : nullptr) {
-    if (!size_) return;
-    storage_type* it = &items_[0];
-    for (const auto& entry : m) {
-      *it++ = &entry;
-    }
-    static_assert(PROTOBUF_FIELD_OFFSET(typename MapT::value_type, first) == 0,
-                  "Must hold for MapSorterPtrLessThan to work.");
-    std::sort(&items_[0], &items_[size_],
-              MapSorterPtrLessThan<typename MapT::key_type>{});
-  }
-  size_t size() const { return size_; }
-  const_iterator begin() const { return {items_.get()}; }
-  const_iterator end() const { return {items_.get() + size_}; }
-
- private:
-  size_t size_;
-  std::unique_ptr<storage_type[]> items_;
+  explicit MapSorterPtr(const MapT& m) : MapSorterBase<MapT>(m) {}
 };
 
 }  // namespace internal
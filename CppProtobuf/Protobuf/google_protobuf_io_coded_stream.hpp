@@ -1682,6 +1682,24 @@ class PROTOBUF_EXPORT CodedInputStream {
   // factory has been provided.
   MessageFactory* GetExtensionFactory();
 
+  // Presizing Repeated Fields -------------------------------------------
+  // By default, the parser grows a repeated field one element at a time. If
+  // enabled, it first counts the elements of each run of a non-packed
+  // repeated field that are already in the buffer, or the varints in a packed
+  // field's length, and reserves room for them once. The extra scan pays off
+  // for fields with many elements, which otherwise reallocate several times.
+  //
+  // Note that this only affects messages parsed with the table-driven parser,
+  // which covers generated and dynamic messages, and only when they are
+  // parsed from this CodedInputStream (e.g. MessageLite::ParseFromCodedStream()
+  // or MergeFromCodedStream()). ParseFromString(), ParseFromArray() and the
+  // other overloads that do not take a CodedInputStream ignore it; to presize
+  // while parsing a flat buffer, wrap the buffer in a CodedInputStream.
+  void SetPresizeRepeatedFields(bool enabled);
+
+  // Returns the value set via SetPresizeRepeatedFields(); false by default.
+  bool GetPresizeRepeatedFields() const;
+
  private:
   const uint8_t* buffer_;
   const uint8_t* buffer_end_;  // pointer to the end of the buffer.
@@ -1704,6 +1722,9 @@ class PROTOBUF_EXPORT CodedInputStream {
   // See EnableAliasing().
   bool aliasing_enabled_;
 
+  // See SetPresizeRepeatedFields().
+  bool presize_repeated_fields_;
+
   // Limits
   Limit current_limit_;  // if position = -1, no limit is applied
 
@@ -2722,6 +2743,14 @@ inline MessageFactory* CodedInputStream::GetExtensionFactory() {
   return extension_factory_;
 }
 
+inline void CodedInputStream::SetPresizeRepeatedFields(bool enabled) {
+  presize_repeated_fields_ = enabled;
+}
+
+inline bool CodedInputStream::GetPresizeRepeatedFields() const {
+  return presize_repeated_fields_;
+}
+
 inline int CodedInputStream::BufferSize() const {
   return static_cast<int>(buffer_end_ - buffer_);
 }
@@ -2735,6 +2764,7 @@ inline CodedInputStream::CodedInputStream(ZeroCopyInputStream* input)
       last_tag_(0),
       legitimate_message_end_(false),
       aliasing_enabled_(false),
+      presize_repeated_fields_(false),
       current_limit_(std::numeric_limits<int32_t>::max()),
       buffer_size_after_limit_(0),
       total_bytes_limit_(kDefaultTotalBytesLimit),
@@ -2755,6 +2785,7 @@ inline CodedInputStream::CodedInputStream(const uint8_t* buffer, int size)
       last_tag_(0),
       legitimate_message_end_(false),
       aliasing_enabled_(false),
+      presize_repeated_fields_(false),
       current_limit_(size),
       buffer_size_after_limit_(0),
       total_bytes_limit_(kDefaultTotalBytesLimit),
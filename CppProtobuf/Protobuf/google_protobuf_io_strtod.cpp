@@ -116,12 +116,6 @@ double NoLocaleStrtod(const char *str, char **endptr) {
 // ----------------------------------------------------------------------
 
 namespace {
-// In practice, doubles should never need more than 24 bytes and floats
-// should never need more than 14 (including null terminators), but we
-// overestimate to be safe.
-constexpr int kDoubleToBufferSize = 32;
-constexpr int kFloatToBufferSize = 24;
-
 inline bool IsValidFloatChar(char c) {
   return ('0' <= c && c <= '9') || c == 'e' || c == 'E' || c == '+' || c == '-';
 }
@@ -161,6 +155,7 @@ bool safe_strtof(const char *str, float *value) {
   *value = strtof(str, &endptr);
   return *str != 0 && *endptr == 0 && errno == 0;
 }
+}  // namespace
 
 char *FloatToBuffer(float value, char *buffer) {
   // FLT_DIG is 6 for IEEE-754 floats, which are used on almost all
@@ -243,7 +238,6 @@ char *DoubleToBuffer(double value, char *buffer) {
   DelocalizeRadix(buffer);
   return buffer;
 }
-}  // namespace
 
 std::string SimpleDtoa(double value) {
   char buffer[kDoubleToBufferSize];
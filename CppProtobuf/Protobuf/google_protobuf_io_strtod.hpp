@@ -1217,6 +1217,19 @@ namespace io {
 PROTOBUF_EXPORT std::string SimpleDtoa(double value);
 PROTOBUF_EXPORT std::string SimpleFtoa(float value);
 
+// In practice, doubles should never need more than 24 bytes and floats
+// should never need more than 14 (including null terminators), but we
+// overestimate to be safe.
+constexpr int kDoubleToBufferSize = 32;
+constexpr int kFloatToBufferSize = 24;
+
+// Like SimpleDtoa() and SimpleFtoa(), but write the null-terminated result
+// into |buffer|, which must hold at least kDoubleToBufferSize or
+// kFloatToBufferSize bytes respectively, instead of allocating a string.
+// Returns |buffer|.
+PROTOBUF_EXPORT char* DoubleToBuffer(double value, char* buffer);
+PROTOBUF_EXPORT char* FloatToBuffer(float value, char* buffer);
+
 // A locale-independent version of the standard strtod(), which always
 // uses a dot as the decimal separator.
 PROTOBUF_EXPORT double NoLocaleStrtod(const char* str, char** endptr);
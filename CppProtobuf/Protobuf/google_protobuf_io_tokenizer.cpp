@@ -1538,7 +1538,26 @@ inline bool Tokenizer::TryConsume(char c) {
 template <typename CharacterClass>
 inline void Tokenizer::ConsumeZeroOrMore() {
   while (CharacterClass::InClass(current_char_)) {
-    NextChar();
+    if (current_char_ == '\n' || current_char_ == '\t') {
+      NextChar();
+      continue;
+    }
+    // Identifiers and numbers make up most of the input, so scan the rest of
+    // the run within the current buffer in one go instead of going through
+    // NextChar() for every character. Newlines and tabs end the run because
+    // they need special column bookkeeping.
+    int end = buffer_pos_ + 1;
+    while (end < buffer_size_ && buffer_[end] != '\n' &&
+           buffer_[end] != '\t' && CharacterClass::InClass(buffer_[end])) {
+      ++end;
+    }
+    column_ += end - buffer_pos_;
+    buffer_pos_ = end;
+    if (buffer_pos_ < buffer_size_) {
+      current_char_ = buffer_[buffer_pos_];
+    } else {
+      Refresh();
+    }
   }
 }
 
@@ -1547,9 +1566,7 @@ inline void Tokenizer::ConsumeOneOrMore(const char* error) {
   if (!CharacterClass::InClass(current_char_)) {
     AddError(error);
   } else {
-    do {
-      NextChar();
-    } while (CharacterClass::InClass(current_char_));
+    ConsumeZeroOrMore<CharacterClass>();
   }
 }
 
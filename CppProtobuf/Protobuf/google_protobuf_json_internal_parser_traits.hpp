@@ -11,6 +11,7 @@
 #include <cfloat>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <string>
@@ -25,6 +26,7 @@
 #include <CppAbseil/absl_strings_str_format.hpp>
 #include <CppAbseil/absl_strings_string_view.hpp>
 #include <CppProtobuf/google_protobuf_io_coded_stream.hpp>
+#include <CppProtobuf/google_protobuf_io_zero_copy_sink.hpp>
 #include <CppProtobuf/google_protobuf_io_zero_copy_stream.hpp>
 #include <CppProtobuf/google_protobuf_io_zero_copy_stream_impl_lite.hpp>
 #include <CppProtobuf/google_protobuf_json_internal_descriptor_traits.hpp>
@@ -1408,13 +1410,128 @@ struct ParseProto2Descriptor : Proto2Descriptor {
 //
 // See MessageTraits for API docs.
 struct ParseProto3Type : Proto3Type {
+  // A single-pass wire format writer.
+  //
+  // A message and all of its length-delimited submessages share one buffer:
+  // submessages are written in place behind a one-byte length placeholder,
+  // which is widened and patched once the submessage ends. This avoids
+  // serializing every nesting level into its own string and then copying it
+  // into its parent.
+  //
+  // Because a ZeroCopyOutputStream cannot be rewound, bytes are handed to the
+  // underlying stream only while no length prefix is pending, so memory use is
+  // bounded by the largest top-level submessage rather than the document.
+  class Writer {
+   public:
+    explicit Writer(io::ZeroCopyOutputStream* stream)
+        : stream_(stream), buf_(&owned_buf_), root_(this) {}
+    explicit Writer(Writer* parent)
+        : buf_(parent->buf_), root_(parent->root_) {}
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    ~Writer() {
+      if (stream_ != nullptr) {
+        Flush();
+      }
+    }
+
+    void WriteTag(uint32_t tag) { WriteVarint32(tag); }
+
+    void WriteVarint32(uint32_t x) {
+      uint8_t bytes[kMaxVarint32Bytes];
+      Append(bytes, io::CodedOutputStream::WriteVarint32ToArray(x, bytes));
+    }
+
+    void WriteVarint64(uint64_t x) {
+      uint8_t bytes[kMaxVarintBytes];
+      Append(bytes, io::CodedOutputStream::WriteVarint64ToArray(x, bytes));
+    }
+
+    void WriteLittleEndian32(uint32_t x) {
+      uint8_t bytes[sizeof(x)];
+      Append(bytes,
+             io::CodedOutputStream::WriteLittleEndian32ToArray(x, bytes));
+    }
+
+    void WriteLittleEndian64(uint64_t x) {
+      uint8_t bytes[sizeof(x)];
+      Append(bytes,
+             io::CodedOutputStream::WriteLittleEndian64ToArray(x, bytes));
+    }
+
+    void WriteRaw(const void* data, size_t size) {
+      buf_->append(static_cast<const char*>(data), size);
+      MaybeFlush();
+    }
+
+    // Starts a length-delimited value whose length is not yet known, and
+    // returns a handle to be passed to EndLengthDelimited().
+    size_t BeginLengthDelimited() {
+      size_t prefix = buf_->size();
+      buf_->push_back('\0');
+      ++root_->pending_prefixes_;
+      return prefix;
+    }
+
+    // Patches the length prefix reserved by BeginLengthDelimited(). Values
+    // shorter than 128 bytes fit the placeholder; longer ones are shifted
+    // once to make room for the full varint.
+    void EndLengthDelimited(size_t prefix) {
+      uint64_t size = buf_->size() - prefix - 1;
+      uint8_t bytes[kMaxVarintBytes];
+      size_t len = static_cast<size_t>(
+          io::CodedOutputStream::WriteVarint64ToArray(size, bytes) - bytes);
+      if (len > 1) {
+        buf_->insert(prefix + 1, len - 1, '\0');
+      }
+      std::memcpy(&(*buf_)[prefix], bytes, len);
+      --root_->pending_prefixes_;
+      MaybeFlush();
+    }
+
+   private:
+    static constexpr int kMaxVarint32Bytes = 5;
+    static constexpr int kMaxVarintBytes = 10;
+    static constexpr size_t kFlushThreshold = 8192;
+
+    void Append(const uint8_t* begin, const uint8_t* end) {
+      WriteRaw(begin, static_cast<size_t>(end - begin));
+    }
+
+    void MaybeFlush() {
+      if (root_->pending_prefixes_ == 0 && buf_->size() >= kFlushThreshold) {
+        root_->Flush();
+      }
+    }
+
+    void Flush() {
+      if (buf_->empty()) return;
+      io::zc_sink_internal::ZeroCopyStreamByteSink sink(stream_);
+      sink.Append(buf_->data(), buf_->size());
+      buf_->clear();
+    }
+
+    // Only set on the root writer, which owns the buffer.
+    io::ZeroCopyOutputStream* stream_ = nullptr;
+    std::string owned_buf_;
+    int pending_prefixes_ = 0;
+
+    std::string* buf_;
+    Writer* root_;
+  };
+
   class Msg {
    public:
     explicit Msg(io::ZeroCopyOutputStream* stream) : stream_(stream) {}
 
    private:
     friend ParseProto3Type;
-    io::CodedOutputStream stream_;
+    // Creates a submessage that writes in place into `parent`'s buffer.
+    explicit Msg(Writer* parent) : stream_(parent) {}
+
+    Writer stream_;
     absl::flat_hash_set<int32_t> parsed_oneofs_indices_;
     absl::flat_hash_set<int32_t> parsed_fields_;
   };
@@ -1459,15 +1576,12 @@ struct ParseProto3Type : Proto3Type {
             return absl::OkStatus();
           }
 
-          std::string out;
-          io::StringOutputStream stream(&out);
-          Msg new_msg(&stream);
+          msg.stream_.WriteTag(f->proto().number() << 3 |
+                               WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+          size_t prefix = msg.stream_.BeginLengthDelimited();
+          Msg new_msg(&msg.stream_);
           RETURN_IF_ERROR(body(desc, new_msg));
-
-          new_msg.stream_.Trim();  // Should probably be called "Flush()".
-          absl::string_view written(
-              out.data(), static_cast<size_t>(new_msg.stream_.ByteCount()));
-          SetString(f, msg, written);
+          msg.stream_.EndLengthDelimited(prefix);
           return absl::OkStatus();
         });
   }
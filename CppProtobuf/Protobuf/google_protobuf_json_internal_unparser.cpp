@@ -1296,7 +1296,8 @@ bool RoundTripsThroughDouble(Int x) {
 // Mutually recursive with functions that follow.
 template <typename Traits>
 absl::Status WriteMessage(JsonWriter& writer, const Msg<Traits>& msg,
-                          const Desc<Traits>& desc, bool is_top_level = false);
+                          const Desc<Traits>& desc, bool is_top_level = false,
+                          const FieldFilter* filter = nullptr);
 
 // This is templatized so that defaults, singular, and repeated fields can both
 // use the same enormous switch-case.
@@ -1537,30 +1538,26 @@ absl::Status WriteMap(JsonWriter& writer, const Msg<Traits>& msg,
   writer.Write("{");
   writer.Push();
 
-  size_t count = Traits::GetSize(field, msg);
   bool first = true;
-  for (size_t i = 0; i < count; ++i) {
-    absl::StatusOr<const Msg<Traits>*> entry =
-        Traits::GetMessage(field, msg, i);
-    RETURN_IF_ERROR(entry.status());
-    const Desc<Traits>& type = Traits::GetDesc(**entry);
-
-    auto is_empty = IsEmptyValue<Traits>(**entry, Traits::ValueField(type));
-    RETURN_IF_ERROR(is_empty.status());
-    if (*is_empty) {
-      // Empty google.protobuf.Values are silently discarded.
-      continue;
-    }
+  RETURN_IF_ERROR(Traits::ForEachMapEntry(
+      field, msg, [&](const Msg<Traits>& entry) -> absl::Status {
+        const Desc<Traits>& type = Traits::GetDesc(entry);
+
+        auto is_empty = IsEmptyValue<Traits>(entry, Traits::ValueField(type));
+        RETURN_IF_ERROR(is_empty.status());
+        if (*is_empty) {
+          // Empty google.protobuf.Values are silently discarded.
+          return absl::OkStatus();
+        }
 
-    writer.WriteComma(first);
-    writer.NewLine();
-    RETURN_IF_ERROR(
-        WriteMapKey<Traits>(writer, **entry, Traits::KeyField(type)));
-    writer.Write(":");
-    writer.Whitespace(" ");
-    RETURN_IF_ERROR(
-        WriteSingular<Traits>(writer, Traits::ValueField(type), **entry));
-  }
+        writer.WriteComma(first);
+        writer.NewLine();
+        RETURN_IF_ERROR(
+            WriteMapKey<Traits>(writer, entry, Traits::KeyField(type)));
+        writer.Write(":");
+        writer.Whitespace(" ");
+        return WriteSingular<Traits>(writer, Traits::ValueField(type), entry);
+      }));
 
   writer.Pop();
   if (!first) {
@@ -1572,7 +1569,8 @@ absl::Status WriteMap(JsonWriter& writer, const Msg<Traits>& msg,
 
 template <typename Traits>
 absl::Status WriteField(JsonWriter& writer, const Msg<Traits>& msg,
-                        Field<Traits> field, bool& first) {
+                        Field<Traits> field, bool& first,
+                        const FieldFilter* filter = nullptr) {
   if (!Traits::IsRepeated(field)) {  // Repeated case is handled in
                                      // WriteRepeated.
     auto is_empty = IsEmptyValue<Traits>(msg, field);
@@ -1627,17 +1625,30 @@ absl::Status WriteField(JsonWriter& writer, const Msg<Traits>& msg,
     return WriteSingular<Traits>(writer, field);
   }
 
+  const FieldFilter* sub_filter =
+      filter == nullptr ? nullptr
+                        : filter->ForMessageField(Traits::FieldNumber(field));
+  if (sub_filter != nullptr) {
+    auto x = Traits::GetMessage(field, msg);
+    RETURN_IF_ERROR(x.status());
+    return WriteMessage<Traits>(writer, **x, Traits::GetDesc(**x),
+                                /*is_top_level=*/false, sub_filter);
+  }
   return WriteSingular<Traits>(writer, field, msg);
 }
 
 template <typename Traits>
 absl::Status WriteFields(JsonWriter& writer, const Msg<Traits>& msg,
-                         const Desc<Traits>& desc, bool& first) {
+                         const Desc<Traits>& desc, bool& first,
+                         const FieldFilter* filter = nullptr) {
   std::vector<Field<Traits>> fields;
   size_t total = Traits::FieldCount(desc);
   fields.reserve(total);
   for (size_t i = 0; i < total; ++i) {
     Field<Traits> field = Traits::FieldByIndex(desc, i);
+    if (filter != nullptr && !filter->IsSelected(Traits::FieldNumber(field))) {
+      continue;
+    }
 
     bool has = Traits::GetSize(field, msg) > 0;
     if (writer.options().always_print_primitive_fields) {
@@ -1661,7 +1672,7 @@ absl::Status WriteFields(JsonWriter& writer, const Msg<Traits>& msg,
   });
 
   for (auto field : fields) {
-    RETURN_IF_ERROR(WriteField<Traits>(writer, msg, field, first));
+    RETURN_IF_ERROR(WriteField<Traits>(writer, msg, field, first, filter));
   }
 
   return absl::OkStatus();
@@ -1973,7 +1984,8 @@ absl::Status WriteAny(JsonWriter& writer, const Msg<Traits>& msg,
 
 template <typename Traits>
 absl::Status WriteMessage(JsonWriter& writer, const Msg<Traits>& msg,
-                          const Desc<Traits>& desc, bool is_top_level) {
+                          const Desc<Traits>& desc, bool is_top_level,
+                          const FieldFilter* filter) {
   switch (ClassifyMessage(Traits::TypeName(desc))) {
     case MessageType::kAny:
       return WriteAny<Traits>(writer, msg, desc);
@@ -2000,7 +2012,7 @@ absl::Status WriteMessage(JsonWriter& writer, const Msg<Traits>& msg,
       writer.Write("{");
       writer.Push();
       bool first = true;
-      RETURN_IF_ERROR(WriteFields<Traits>(writer, msg, desc, first));
+      RETURN_IF_ERROR(WriteFields<Traits>(writer, msg, desc, first, filter));
       writer.Pop();
       if (!first) {
         writer.NewLine();
@@ -2013,14 +2025,16 @@ absl::Status WriteMessage(JsonWriter& writer, const Msg<Traits>& msg,
 }  // namespace
 
 absl::Status MessageToJsonString(const Message& message, std::string* output,
-                                 json_internal::WriterOptions options) {
+                                 json_internal::WriterOptions options,
+                                 const FieldFilter* filter) {
   if (PROTOBUF_DEBUG) {
     ABSL_DLOG(INFO) << "json2/input: " << message.DebugString();
   }
   io::StringOutputStream out(output);
   JsonWriter writer(&out, options);
   absl::Status s = WriteMessage<UnparseProto2Descriptor>(
-      writer, message, *message.GetDescriptor(), /*is_top_level=*/true);
+      writer, message, *message.GetDescriptor(), /*is_top_level=*/true,
+      filter);
   if (PROTOBUF_DEBUG) ABSL_DLOG(INFO) << "json2/status: " << s;
   RETURN_IF_ERROR(s);
 
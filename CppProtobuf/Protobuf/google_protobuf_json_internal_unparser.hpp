@@ -18,10 +18,25 @@
 namespace google {
 namespace protobuf {
 namespace json_internal {
+// Selects the fields of a message that MessageToJsonString() prints.
+// Extensions are always printed.
+class FieldFilter {
+ public:
+  virtual ~FieldFilter() = default;
+
+  // Returns whether the field with the given number is printed.
+  virtual bool IsSelected(int field_number) const = 0;
+
+  // Returns the filter for the fields of the singular message field with the
+  // given number, or nullptr if all of them are printed.
+  virtual const FieldFilter* ForMessageField(int field_number) const = 0;
+};
+
 // Internal version of google::protobuf::util::MessageToJsonString; see json_util.h for
-// details.
+// details. If filter is not null, only the fields it selects are printed.
 absl::Status MessageToJsonString(const Message& message, std::string* output,
-                                 json_internal::WriterOptions options);
+                                 json_internal::WriterOptions options,
+                                 const FieldFilter* filter = nullptr);
 // Internal version of google::protobuf::util::BinaryToJsonStream; see json_util.h for
 // details.
 absl::Status BinaryToJsonStream(google::protobuf::util::TypeResolver* resolver,
@@ -29,6 +29,7 @@
 #include <CppAbseil/absl_types_variant.hpp>
 #include <CppProtobuf/google_protobuf_io_coded_stream.hpp>
 #include <CppProtobuf/google_protobuf_json_internal_descriptor_traits.hpp>
+#include <CppProtobuf/google_protobuf_map_field.hpp>
 #include <CppProtobuf/google_protobuf_stubs_status_macros.hpp>
 
 // Must be included last.
@@ -1391,6 +1392,18 @@ struct UnparseProto2Descriptor : Proto2Descriptor {
     return &msg.GetReflection()->GetRepeatedMessage(msg, f, idx);
   }
 
+  // Calls `body` with each entry of the map field `f`. The map is read
+  // directly, so it never has to build its repeated representation; an entry
+  // is only valid during its call.
+  template <typename F>
+  static absl::Status ForEachMapEntry(Field f, const Msg& msg, F body) {
+    internal::MapEntryReader entries(msg, f, /*sorted=*/false);
+    while (const Msg* entry = entries.Next()) {
+      RETURN_IF_ERROR(body(*entry));
+    }
+    return absl::OkStatus();
+  }
+
   template <typename F>
   static absl::Status WithDecodedMessage(const Desc& desc,
                                          absl::string_view data, F body) {
@@ -1575,6 +1588,14 @@ struct UnparseProto3Type : Proto3Type {
     return &msg.Get<Msg>(f->proto().number())[idx];
   }
 
+  template <typename F>
+  static absl::Status ForEachMapEntry(Field f, const Msg& msg, F body) {
+    for (const Msg& entry : msg.Get<Msg>(f->proto().number())) {
+      RETURN_IF_ERROR(body(entry));
+    }
+    return absl::OkStatus();
+  }
+
   template <typename F>
   static absl::Status WithDecodedMessage(const Desc& desc,
                                          absl::string_view data, F body) {
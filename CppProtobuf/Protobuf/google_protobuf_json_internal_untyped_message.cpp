@@ -1253,11 +1253,11 @@ absl::StatusOr<const ResolverPool::Enum*> ResolverPool::Field::EnumType()
 
 absl::Span<const ResolverPool::Field> ResolverPool::Message::FieldsByIndex()
     const {
-  if (raw_.fields_size() > 0 && fields_ == nullptr) {
-    fields_ = std::unique_ptr<Field[]>(new Field[raw_.fields_size()]);
-    for (size_t i = 0; i < raw_.fields_size(); ++i) {
+  if (raw_->fields_size() > 0 && fields_ == nullptr) {
+    fields_ = std::unique_ptr<Field[]>(new Field[raw_->fields_size()]);
+    for (size_t i = 0; i < raw_->fields_size(); ++i) {
       fields_[i].pool_ = pool_;
-      fields_[i].raw_ = &raw_.fields(i);
+      fields_[i].raw_ = &raw_->fields(i);
       fields_[i].parent_ = this;
     }
   }
@@ -1267,10 +1267,17 @@ absl::Span<const ResolverPool::Field> ResolverPool::Message::FieldsByIndex()
 
 const ResolverPool::Field* ResolverPool::Message::FindField(
     absl::string_view name) const {
-  if (raw_.fields_size() == 0) {
+  if (raw_->fields_size() == 0) {
     return nullptr;
   }
 
+  if (cached_ != nullptr) {
+    auto it = cached_->fields_by_name.find(name);
+    return it == cached_->fields_by_name.end()
+               ? nullptr
+               : &FieldsByIndex()[it->second];
+  }
+
   if (fields_by_name_.empty()) {
     const Field* found = nullptr;
     for (auto& field : FieldsByIndex()) {
@@ -1289,11 +1296,18 @@ const ResolverPool::Field* ResolverPool::Message::FindField(
 
 const ResolverPool::Field* ResolverPool::Message::FindField(
     int32_t number) const {
-  if (raw_.fields_size() == 0) {
+  if (raw_->fields_size() == 0) {
     return nullptr;
   }
 
-  bool is_small = raw_.fields_size() < 8;
+  if (cached_ != nullptr) {
+    auto it = cached_->fields_by_number.find(number);
+    return it == cached_->fields_by_number.end()
+               ? nullptr
+               : &FieldsByIndex()[it->second];
+  }
+
+  bool is_small = raw_->fields_size() < 8;
   if (is_small || fields_by_number_.empty()) {
     const Field* found = nullptr;
     for (auto& field : FieldsByIndex()) {
@@ -1320,7 +1334,14 @@ absl::StatusOr<const ResolverPool::Message*> ResolverPool::FindMessage(
 
   auto msg = absl::WrapUnique(new Message(this));
   std::string url_buf(url);
-  RETURN_IF_ERROR(resolver_->ResolveMessageType(url_buf, &msg->raw_));
+  if (cache_ != nullptr) {
+    auto cached = cache_->FindMessageType(url_buf);
+    RETURN_IF_ERROR(cached.status());
+    msg->cached_ = *std::move(cached);
+    msg->raw_ = &msg->cached_->type;
+  } else {
+    RETURN_IF_ERROR(resolver_->ResolveMessageType(url_buf, &msg->owned_));
+  }
 
   return messages_.try_emplace(std::move(url_buf), std::move(msg))
       .first->second.get();
@@ -1335,7 +1356,14 @@ absl::StatusOr<const ResolverPool::Enum*> ResolverPool::FindEnum(
 
   auto enoom = absl::WrapUnique(new Enum(this));
   std::string url_buf(url);
-  RETURN_IF_ERROR(resolver_->ResolveEnumType(url_buf, &enoom->raw_));
+  if (cache_ != nullptr) {
+    auto cached = cache_->FindEnumType(url_buf);
+    RETURN_IF_ERROR(cached.status());
+    enoom->cached_ = *std::move(cached);
+    enoom->raw_ = enoom->cached_.get();
+  } else {
+    RETURN_IF_ERROR(resolver_->ResolveEnumType(url_buf, &enoom->owned_));
+  }
 
   return enums_.try_emplace(std::move(url_buf), std::move(enoom))
       .first->second.get();
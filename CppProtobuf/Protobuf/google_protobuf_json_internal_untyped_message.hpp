@@ -29,6 +29,7 @@
 #include <CppProtobuf/google_protobuf_io_coded_stream.hpp>
 #include <CppProtobuf/google_protobuf_message.hpp>
 #include <CppProtobuf/google_protobuf_util_type_resolver.hpp>
+#include <CppProtobuf/google_protobuf_util_type_resolver_util.hpp>
 #include <CppProtobuf/google_protobuf_wire_format.hpp>
 #include <CppProtobuf/google_protobuf_wire_format_lite.hpp>
 #include <CppProtobuf/google_protobuf_stubs_status_macros.hpp>
@@ -1271,7 +1272,7 @@ class ResolverPool {
     const Field* FindField(absl::string_view name) const;
     const Field* FindField(int32_t number) const;
 
-    const google::protobuf::Type& proto() const { return raw_; }
+    const google::protobuf::Type& proto() const { return *raw_; }
     ResolverPool* pool() const { return pool_; }
 
    private:
@@ -1280,7 +1281,13 @@ class ResolverPool {
     explicit Message(ResolverPool* pool) : pool_(pool) {}
 
     ResolverPool* pool_;
-    google::protobuf::Type raw_;
+    // Either owned_, or the type in cached_ if the resolver caches types, in
+    // which case cached_ also provides the field lookup tables.
+    const google::protobuf::Type* raw_ = &owned_;
+    google::protobuf::Type owned_;
+    std::shared_ptr<
+        const google::protobuf::util::CachingTypeResolver::MessageType>
+        cached_;
     mutable std::unique_ptr<Field[]> fields_;
     mutable absl::flat_hash_map<absl::string_view, const Field*>
         fields_by_name_;
@@ -1292,7 +1299,7 @@ class ResolverPool {
     Enum(const Enum&) = delete;
     Enum& operator=(const Enum&) = delete;
 
-    const google::protobuf::Enum& proto() const { return raw_; }
+    const google::protobuf::Enum& proto() const { return *raw_; }
     ResolverPool* pool() const { return pool_; }
 
    private:
@@ -1301,13 +1308,16 @@ class ResolverPool {
     explicit Enum(ResolverPool* pool) : pool_(pool) {}
 
     ResolverPool* pool_;
-    google::protobuf::Enum raw_;
+    // Either owned_, or cached_ if the resolver caches types.
+    const google::protobuf::Enum* raw_ = &owned_;
+    google::protobuf::Enum owned_;
+    std::shared_ptr<const google::protobuf::Enum> cached_;
     mutable absl::flat_hash_map<absl::string_view, google::protobuf::EnumValue*>
         values_;
   };
 
   explicit ResolverPool(google::protobuf::util::TypeResolver* resolver)
-      : resolver_(resolver) {}
+      : resolver_(resolver), cache_(resolver->AsCachingTypeResolver()) {}
 
   ResolverPool(const ResolverPool&) = delete;
   ResolverPool& operator=(const ResolverPool&) = delete;
@@ -1319,6 +1329,7 @@ class ResolverPool {
   absl::flat_hash_map<std::string, std::unique_ptr<Message>> messages_;
   absl::flat_hash_map<std::string, std::unique_ptr<Enum>> enums_;
   google::protobuf::util::TypeResolver* resolver_;
+  google::protobuf::util::CachingTypeResolver* cache_;
 };
 
 // A parsed wire-format proto that uses TypeReslover for parsing.
@@ -7,9 +7,17 @@
 
 #include "google_protobuf_json_json.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include <CppAbseil/absl_status_status.hpp>
+#include <CppAbseil/absl_strings_ascii.hpp>
+#include <CppAbseil/absl_strings_str_cat.hpp>
 #include <CppAbseil/absl_strings_string_view.hpp>
 #include "google_protobuf_io_zero_copy_stream.hpp"
 #include "google_protobuf_json_internal_parser.hpp"
@@ -1205,6 +1213,86 @@ PROTOBUF_EXPORT void protobuf_assumption_failed(const char *pred,
 namespace google {
 namespace protobuf {
 namespace json {
+namespace {
+// Splits newline-delimited JSON into one record per non-blank line. Raw
+// newlines cannot occur inside JSON strings, so no further scanning is needed.
+void SplitJsonLines(absl::string_view input,
+                    std::vector<absl::string_view>* records) {
+  while (!input.empty()) {
+    size_t end = input.find('\n');
+    absl::string_view line = absl::StripAsciiWhitespace(input.substr(0, end));
+    if (!line.empty()) {
+      records->push_back(line);
+    }
+    if (end == absl::string_view::npos) break;
+    input.remove_prefix(end + 1);
+  }
+}
+
+// Splits a top-level JSON array, which must start at input[0], into its
+// elements. Only string literals and bracket nesting are tracked; the records
+// themselves are validated when they are parsed.
+absl::Status SplitJsonArray(absl::string_view input,
+                            std::vector<absl::string_view>* records) {
+  int depth = 0;
+  size_t start = 1;
+  bool saw_comma = false;
+  auto add_record = [&](size_t end, bool last) -> absl::Status {
+    absl::string_view record =
+        absl::StripAsciiWhitespace(input.substr(start, end - start));
+    if (record.empty()) {
+      if (last && !saw_comma) return absl::OkStatus();  // Empty array.
+      return absl::InvalidArgumentError(
+          absl::StrCat("empty element in JSON array at offset ", end));
+    }
+    records->push_back(record);
+    return absl::OkStatus();
+  };
+
+  for (size_t i = 0; i < input.size(); ++i) {
+    switch (input[i]) {
+      case '"':
+        // Jump over the string literal, honoring escapes.
+        for (i = input.find_first_of("\"\\", i + 1);
+             i != absl::string_view::npos && input[i] == '\\';
+             i = input.find_first_of("\"\\", i + 2)) {
+        }
+        if (i == absl::string_view::npos) {
+          return absl::InvalidArgumentError("unexpected EOF in JSON string");
+        }
+        break;
+      case '[':
+      case '{':
+        ++depth;
+        break;
+      case ']':
+      case '}':
+        if (--depth > 0) break;
+        if (input[i] != ']') {
+          return absl::InvalidArgumentError(
+              absl::StrCat("mismatched '}' at offset ", i));
+        }
+        RETURN_IF_ERROR(add_record(i, /*last=*/true));
+        if (!absl::StripAsciiWhitespace(input.substr(i + 1)).empty()) {
+          return absl::InvalidArgumentError(
+              "extraneous characters after end of JSON array");
+        }
+        return absl::OkStatus();
+      case ',':
+        if (depth == 1) {
+          RETURN_IF_ERROR(add_record(i, /*last=*/false));
+          saw_comma = true;
+          start = i + 1;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return absl::InvalidArgumentError("unexpected EOF in JSON array");
+}
+}  // namespace
+
 
 absl::Status BinaryToJsonStream(google::protobuf::util::TypeResolver* resolver,
                                 const std::string& type_url,
@@ -1289,6 +1377,71 @@ absl::Status JsonStringToMessage(absl::string_view input, Message* message,
 
   return google::protobuf::json_internal::JsonStringToMessage(input, message, opts);
 }
+
+absl::Status JsonRecordsToMessages(absl::string_view input,
+                                   const Message& prototype,
+                                   JsonRecords* records,
+                                   const ParseOptions& options,
+                                   int num_threads) {
+  records->messages.clear();
+  records->arenas.clear();
+
+  std::vector<absl::string_view> inputs;
+  absl::string_view trimmed = absl::StripLeadingAsciiWhitespace(input);
+  if (!trimmed.empty() && trimmed.front() == '[') {
+    RETURN_IF_ERROR(SplitJsonArray(trimmed, &inputs));
+  } else {
+    SplitJsonLines(trimmed, &inputs);
+  }
+  if (inputs.empty()) return absl::OkStatus();
+
+  if (num_threads <= 0) {
+    num_threads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  size_t workers = std::min(inputs.size(),
+                            static_cast<size_t>(std::max(num_threads, 1)));
+
+  // Each worker parses a contiguous run of records onto its own arena, which
+  // keeps the output in input order without any synchronization.
+  std::vector<std::unique_ptr<Arena>> arenas(workers);
+  std::vector<Message*> messages(inputs.size());
+  std::vector<std::pair<size_t, absl::Status>> failures(workers);
+  auto parse_run = [&](size_t worker) {
+    arenas[worker] = std::make_unique<Arena>();
+    size_t begin = inputs.size() * worker / workers;
+    size_t end = inputs.size() * (worker + 1) / workers;
+    for (size_t i = begin; i < end; ++i) {
+      messages[i] = prototype.New(arenas[worker].get());
+      absl::Status status = JsonStringToMessage(inputs[i], messages[i], options);
+      if (!status.ok()) {
+        failures[worker] = {i, std::move(status)};
+        return;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(workers - 1);
+  for (size_t worker = 1; worker < workers; ++worker) {
+    threads.emplace_back(parse_run, worker);
+  }
+  parse_run(0);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // Runs are ordered, so the first failing run holds the first failure.
+  for (const auto& failure : failures) {
+    if (!failure.second.ok()) {
+      return absl::Status(failure.second.code(),
+                          absl::StrCat("record ", failure.first, ": ",
+                                       failure.second.message()));
+    }
+  }
+  records->arenas = std::move(arenas);
+  records->messages = std::move(messages);
+  return absl::OkStatus();
+}
 }  // namespace json
 }  // namespace protobuf
 }  // namespace google
@@ -10,10 +10,13 @@
 #ifndef GOOGLE_PROTOBUF_JSON_JSON_H__
 #define GOOGLE_PROTOBUF_JSON_JSON_H__
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <CppAbseil/absl_status_status.hpp>
 #include <CppAbseil/absl_strings_string_view.hpp>
+#include <CppProtobuf/google_protobuf_arena.hpp>
 #include <CppProtobuf/google_protobuf_message.hpp>
 #include <CppProtobuf/google_protobuf_util_type_resolver.hpp>
 
@@ -1266,6 +1269,38 @@ inline absl::Status JsonStringToMessage(absl::string_view input,
   return JsonStringToMessage(input, message, ParseOptions());
 }
 
+// The output of JsonRecordsToMessages(). Records are parsed onto one arena per
+// worker thread, so the messages stay valid for as long as this object does.
+struct JsonRecords {
+  std::vector<std::unique_ptr<Arena>> arenas;
+  // One message per input record, in input order.
+  std::vector<Message*> messages;
+};
+
+// Converts a batch of JSON records to messages of the same type as
+// |prototype|. |input| is either a top-level JSON array or newline-delimited
+// JSON (one record per line; blank lines are skipped).
+//
+// Record boundaries are located by a structural pre-scan that only tracks
+// string literals and bracket nesting; the records are then parsed
+// concurrently on up to |num_threads| threads (0 means one per hardware
+// thread), each one exactly as JsonStringToMessage() would.
+//
+// If any record fails to parse, the status of the first failing record is
+// returned with its index prepended, and |records| is left empty.
+PROTOBUF_EXPORT absl::Status JsonRecordsToMessages(absl::string_view input,
+                                                   const Message& prototype,
+                                                   JsonRecords* records,
+                                                   const ParseOptions& options,
+                                                   int num_threads);
+
+inline absl::Status JsonRecordsToMessages(absl::string_view input,
+                                          const Message& prototype,
+                                          JsonRecords* records) {
+  return JsonRecordsToMessages(input, prototype, records, ParseOptions(),
+                               /*num_threads=*/0);
+}
+
 // Converts protobuf binary data to JSON.
 // The conversion will fail if:
 //   1. TypeResolver fails to resolve a type.
@@ -1300,6 +1300,7 @@ TableEntryPtr UntypedMapBase::ConvertToTree(NodeBase* node, GetKey get_key) {
 
 void UntypedMapBase::ClearTable(const ClearInput input) {
   ABSL_DCHECK_NE(num_buckets_, kGlobalEmptyTableSize);
+  InvalidateSortedNodes();
 
   if (alloc_.arena() == nullptr) {
     const auto loop = [=](auto destroy_node) {
@@ -1362,10 +1363,16 @@ void UntypedMapBase::ClearTable(const ClearInput input) {
 
   if (input.reset_table) {
     std::fill(table_, table_ + num_buckets_, TableEntryPtr{});
+    if (open_addressing_) {
+      memset(ctrl(), kCtrlEmpty, num_buckets_);
+      num_deleted_ = 0;
+    }
     num_elements_ = 0;
     index_of_first_non_null_ = num_buckets_;
+    reserved_ = false;
   } else {
     DeleteTable(table_, num_buckets_);
+    DeleteSortedNodes();
   }
 }
 
@@ -1384,6 +1391,10 @@ size_t UntypedMapBase::SpaceUsedInTable(size_t sizeof_node) const {
   size_t size = 0;
   // The size of the table.
   size += sizeof(void*) * num_buckets_;
+  if (open_addressing_) {
+    // The control bytes.
+    size += num_buckets_;
+  }
   // All the nodes.
   size += sizeof_node * num_elements_;
   // For each tree, count the overhead of those nodes.
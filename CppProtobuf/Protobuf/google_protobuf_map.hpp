@@ -15,12 +15,16 @@
 #define GOOGLE_PROTOBUF_MAP_H__
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <initializer_list>
 #include <iterator>
 #include <limits>  // To support Visual Studio 2008
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 
@@ -28,11 +32,16 @@
 #include <mach/mach_time.h>
 #endif
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include <CppProtobuf/google_protobuf_stubs_common.hpp>
 #include <CppAbseil/absl_base_attributes.hpp>
 #include <CppAbseil/absl_container_btree_map.hpp>
 #include <CppAbseil/absl_hash_hash.hpp>
 #include <CppAbseil/absl_meta_type_traits.hpp>
+#include <CppAbseil/absl_numeric_bits.hpp>
 #include <CppAbseil/absl_strings_string_view.hpp>
 #include <CppProtobuf/google_protobuf_arena.hpp>
 #include <CppProtobuf/google_protobuf_generated_enum_util.hpp>
@@ -1257,6 +1266,9 @@ struct MapBenchmarkPeer;
 template <typename Key, typename T>
 class TypeDefinedMapFieldBase;
 
+template <typename MapT>
+class MapSorterBase;
+
 class DynamicMapField;
 
 class GeneratedMessageReflection;
@@ -1489,6 +1501,11 @@ struct NodeBase {
   }
 };
 
+// Declared in generated_message_util.h for MapSorterBase.
+inline const void* GetMapNodeKey(const NodeBase* node) {
+  return node->GetVoidKey();
+}
+
 inline NodeBase* EraseFromLinkedList(NodeBase* item, NodeBase* head) {
   if (head == item) {
     return head->next;
@@ -1650,6 +1667,64 @@ N MultiplyWithOverflow(N a, N b) {
 
 inline size_t SpaceUsedInValues(const void*) { return 0; }
 
+// Control bytes for the open-addressing index (see
+// Map::set_open_addressing()). A full slot holds a 7-bit tag taken from the
+// key's hash, so the high bit distinguishes full slots from available ones.
+enum : uint8_t {
+  kCtrlEmpty = 0x80,
+  kCtrlDeleted = 0xFE,
+};
+
+// A group of consecutive control bytes that is matched against a tag at once.
+// Match results are bitmasks with one set bit, or byte, per matching slot;
+// Index() converts the lowest one back into a slot offset within the group.
+#if defined(__SSE2__)
+struct CtrlGroup {
+  static constexpr uint32_t kWidth = 16;
+
+  explicit CtrlGroup(const uint8_t* pos)
+      : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+  uint32_t Match(uint8_t tag) const {
+    return static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(tag)), ctrl)));
+  }
+  uint32_t MatchEmpty() const { return Match(kCtrlEmpty); }
+  // Empty or deleted slots: the only control bytes with the high bit set.
+  uint32_t MatchAvailable() const {
+    return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+  }
+  static uint32_t Index(uint32_t mask) { return absl::countr_zero(mask); }
+
+  __m128i ctrl;
+};
+#else   // __SSE2__
+struct CtrlGroup {
+  static constexpr uint32_t kWidth = 8;
+  static constexpr uint64_t kLsbs = 0x0101010101010101;
+  static constexpr uint64_t kMsbs = 0x8080808080808080;
+
+  explicit CtrlGroup(const uint8_t* pos) {
+    memcpy(&ctrl, pos, sizeof(ctrl));
+#if defined(ABSL_IS_BIG_ENDIAN)
+    ctrl = __builtin_bswap64(ctrl);
+#endif
+  }
+
+  // May report a false positive for a full slot that follows a real match;
+  // callers compare keys anyway.
+  uint64_t Match(uint8_t tag) const {
+    const uint64_t x = ctrl ^ (kLsbs * tag);
+    return (x - kLsbs) & ~x & kMsbs;
+  }
+  uint64_t MatchEmpty() const { return ctrl & ~(ctrl << 6) & kMsbs; }
+  uint64_t MatchAvailable() const { return ctrl & kMsbs; }
+  static uint32_t Index(uint64_t mask) { return absl::countr_zero(mask) >> 3; }
+
+  uint64_t ctrl;
+};
+#endif  // __SSE2__
+
 class UntypedMapBase;
 
 class UntypedMapIterator {
@@ -1711,6 +1786,12 @@ class PROTOBUF_EXPORT UntypedMapBase {
         num_buckets_(internal::kGlobalEmptyTableSize),
         seed_(0),
         index_of_first_non_null_(internal::kGlobalEmptyTableSize),
+        num_deleted_(0),
+        open_addressing_(false),
+        reserved_(false),
+        sorted_nodes_(nullptr),
+        sorted_nodes_capacity_(0),
+        sorted_nodes_state_(kSortedNodesStale),
         table_(const_cast<TableEntryPtr*>(internal::kGlobalEmptyTable)),
         alloc_(arena) {}
 
@@ -1718,7 +1799,12 @@ class PROTOBUF_EXPORT UntypedMapBase {
   UntypedMapBase& operator=(const UntypedMapBase&) = delete;
 
  protected:
-  enum { kMinTableSize = 8 };
+  enum : map_index_t {
+    kMinTableSize = 8,
+    // The open-addressing index needs at least one whole control group.
+    kMinOpenTableSize = 16,
+  };
+  static_assert(kMinOpenTableSize >= CtrlGroup::kWidth, "");
 
  public:
   Arena* arena() const { return this->alloc_.arena(); }
@@ -1728,6 +1814,16 @@ class PROTOBUF_EXPORT UntypedMapBase {
     std::swap(num_buckets_, other->num_buckets_);
     std::swap(seed_, other->seed_);
     std::swap(index_of_first_non_null_, other->index_of_first_non_null_);
+    std::swap(num_deleted_, other->num_deleted_);
+    std::swap(open_addressing_, other->open_addressing_);
+    std::swap(reserved_, other->reserved_);
+    std::swap(sorted_nodes_, other->sorted_nodes_);
+    std::swap(sorted_nodes_capacity_, other->sorted_nodes_capacity_);
+    other->sorted_nodes_state_.store(
+        sorted_nodes_state_.exchange(other->sorted_nodes_state_.load(
+                                         std::memory_order_relaxed),
+                                     std::memory_order_relaxed),
+        std::memory_order_relaxed);
     std::swap(table_, other->table_);
     std::swap(alloc_, other->alloc_);
   }
@@ -1737,6 +1833,7 @@ class PROTOBUF_EXPORT UntypedMapBase {
   }
   size_type size() const { return num_elements_; }
   bool empty() const { return size() == 0; }
+  bool open_addressing() const { return open_addressing_; }
 
   UntypedMapIterator begin() const { return UntypedMapIterator(this); }
   // We make this a static function to reduce the cost in MapField.
@@ -1803,9 +1900,75 @@ class PROTOBUF_EXPORT UntypedMapBase {
   // Return a power of two no less than max(kMinTableSize, n).
   // Assumes either n < kMinTableSize or n is a power of two.
   map_index_t TableSize(map_index_t n) {
-    return n < static_cast<map_index_t>(kMinTableSize)
-               ? static_cast<map_index_t>(kMinTableSize)
-               : n;
+    return n < MinTableSize() ? MinTableSize() : n;
+  }
+
+  map_index_t MinTableSize() const {
+    return open_addressing_ ? kMinOpenTableSize : kMinTableSize;
+  }
+
+  // Controls RAM vs CPU tradeoff. Open addressing has no lists to walk and
+  // can run at a higher load, but deleted slots count against it until the
+  // next rehash.
+  static size_type MaxLoadTimes16(bool open_addressing) {
+    return open_addressing ? 14 : 12;
+  }
+
+  // The open-addressing index keeps one control byte per slot right after the
+  // slots themselves, in the same allocation.
+  static size_t TableAllocSize(map_index_t n, bool open_addressing) {
+    return open_addressing ? n + n / sizeof(TableEntryPtr) : n;
+  }
+  uint8_t* ctrl() const {
+    return reinterpret_cast<uint8_t*>(table_ + num_buckets_);
+  }
+
+  // Open addressing: the high bits of the mixed hash pick the group where
+  // probing starts, and bits below them give the tag stored in the control
+  // byte, so tag matches are independent of the slot that is probed.
+  static uint8_t CtrlTag(uint64_t mixed) {
+    return static_cast<uint8_t>((mixed >> 25) & 0x7F);
+  }
+  map_index_t FirstGroup(uint64_t mixed) const {
+    return ((mixed >> 32) & (num_buckets_ - 1)) / CtrlGroup::kWidth;
+  }
+  map_index_t GroupMask() const {
+    return num_buckets_ / CtrlGroup::kWidth - 1;
+  }
+
+  // Returns the first empty or deleted slot on the probe sequence.
+  map_index_t FindAvailableSlot(uint64_t mixed) const {
+    map_index_t g = FirstGroup(mixed);
+    for (map_index_t step = 1;; ++step) {
+      const map_index_t base = g * CtrlGroup::kWidth;
+      const auto available = CtrlGroup(ctrl() + base).MatchAvailable();
+      if (available != 0) return base + CtrlGroup::Index(available);
+      g = (g + step) & GroupMask();
+    }
+  }
+
+  // Fills the available slot b with node.
+  void InsertIntoSlot(map_index_t b, NodeBase* node, uint8_t tag) {
+    ABSL_DCHECK(table_[b] == TableEntryPtr{});
+    ABSL_DCHECK_NE(ctrl()[b] & kCtrlEmpty, 0);
+    if (ctrl()[b] == kCtrlDeleted) --num_deleted_;
+    ctrl()[b] = tag;
+    node->next = nullptr;
+    table_[b] = NodeToTableEntry(node);
+    index_of_first_non_null_ = (std::min)(index_of_first_non_null_, b);
+  }
+
+  // Marks slot b as no longer in use. It can go back to empty if its group
+  // still has an empty slot: no probe sequence has ever continued past such
+  // a group, so nothing relies on this slot being occupied.
+  void EraseFromSlot(map_index_t b) {
+    const map_index_t base = b & ~(CtrlGroup::kWidth - 1);
+    if (CtrlGroup(ctrl() + base).MatchEmpty() != 0) {
+      ctrl()[b] = kCtrlEmpty;
+    } else {
+      ctrl()[b] = kCtrlDeleted;
+      ++num_deleted_;
+    }
   }
 
   template <typename T>
@@ -1831,7 +1994,71 @@ class PROTOBUF_EXPORT UntypedMapBase {
   }
 
   void DeleteTable(TableEntryPtr* table, map_index_t n) {
-    AllocFor<TableEntryPtr>(alloc_).deallocate(table, n);
+    DeleteTable(table, n, open_addressing_);
+  }
+
+  void DeleteTable(TableEntryPtr* table, map_index_t n, bool open_addressing) {
+    AllocFor<TableEntryPtr>(alloc_).deallocate(
+        table, TableAllocSize(n, open_addressing));
+  }
+
+  // Returns the nodes ordered by `less`, reusing the order from the previous
+  // call unless an element was inserted or erased since. Safe to call
+  // concurrently on a map that is not being modified: one caller sorts while
+  // the others wait for it.
+  template <typename LessThan>
+  NodeBase* const* SortedNodes(LessThan less) const {
+    if (num_elements_ == 0) return nullptr;
+    uint8_t state = sorted_nodes_state_.load(std::memory_order_acquire);
+    while (state != kSortedNodesValid) {
+      if (state == kSortedNodesBuilding) {
+        std::this_thread::yield();
+        state = sorted_nodes_state_.load(std::memory_order_acquire);
+      } else if (sorted_nodes_state_.compare_exchange_weak(
+                     state, kSortedNodesBuilding, std::memory_order_acquire)) {
+        BuildSortedNodes(less);
+        sorted_nodes_state_.store(kSortedNodesValid, std::memory_order_release);
+        break;
+      }
+    }
+    return sorted_nodes_;
+  }
+
+  // Must be called before an element is inserted or erased. The array is kept
+  // for the next SortedNodes() call.
+  void InvalidateSortedNodes() {
+    sorted_nodes_state_.store(kSortedNodesStale, std::memory_order_relaxed);
+  }
+
+  void DeleteSortedNodes() {
+    if (sorted_nodes_ != nullptr) {
+      AllocFor<NodeBase*>(alloc_).deallocate(sorted_nodes_,
+                                             sorted_nodes_capacity_);
+      sorted_nodes_ = nullptr;
+      sorted_nodes_capacity_ = 0;
+    }
+    sorted_nodes_state_.store(kSortedNodesStale, std::memory_order_relaxed);
+  }
+
+  template <typename LessThan>
+  void BuildSortedNodes(LessThan less) const {
+    if (sorted_nodes_capacity_ < num_elements_) {
+      // Grow geometrically: arena maps cannot free the old array, so this
+      // bounds what a map that keeps growing leaves behind on the arena.
+      const map_index_t capacity =
+          std::max(num_elements_, 2 * sorted_nodes_capacity_);
+      if (sorted_nodes_ != nullptr) {
+        AllocFor<NodeBase*>(alloc_).deallocate(sorted_nodes_,
+                                               sorted_nodes_capacity_);
+      }
+      sorted_nodes_ = AllocFor<NodeBase*>(alloc_).allocate(capacity);
+      sorted_nodes_capacity_ = capacity;
+    }
+    NodeBase** out = sorted_nodes_;
+    for (UntypedMapIterator it(this); it.node_ != nullptr; it.PlusPlus()) {
+      *out++ = it.node_;
+    }
+    std::sort(sorted_nodes_, out, less);
   }
 
   NodeBase* DestroyTree(Tree* tree);
@@ -1844,6 +2071,10 @@ class PROTOBUF_EXPORT UntypedMapBase {
   map_index_t VariantBucketNumber(VariantKey key) const;
 
   map_index_t BucketNumberFromHash(uint64_t h) const {
+    return (MixHash(h) >> 32) & (num_buckets_ - 1);
+  }
+
+  uint64_t MixHash(uint64_t h) const {
     // We xor the hash value against the random seed so that we effectively
     // have a random hash function.
     h ^= seed_;
@@ -1852,14 +2083,18 @@ class PROTOBUF_EXPORT UntypedMapBase {
     // the hash value. The constant kPhi (suggested by Knuth) is roughly
     // (sqrt(5) - 1) / 2 * 2^64.
     constexpr uint64_t kPhi = uint64_t{0x9e3779b97f4a7c15};
-    return (MultiplyWithOverflow(kPhi, h) >> 32) & (num_buckets_ - 1);
+    return MultiplyWithOverflow(kPhi, h);
   }
 
   TableEntryPtr* CreateEmptyTable(map_index_t n) {
-    ABSL_DCHECK_GE(n, map_index_t{kMinTableSize});
+    ABSL_DCHECK_GE(n, MinTableSize());
     ABSL_DCHECK_EQ(n & (n - 1), 0u);
-    TableEntryPtr* result = AllocFor<TableEntryPtr>(alloc_).allocate(n);
+    TableEntryPtr* result = AllocFor<TableEntryPtr>(alloc_).allocate(
+        TableAllocSize(n, open_addressing_));
     memset(result, 0, n * sizeof(result[0]));
+    if (open_addressing_) {
+      memset(result + n, kCtrlEmpty, n);
+    }
     return result;
   }
 
@@ -1951,6 +2186,25 @@ class PROTOBUF_EXPORT UntypedMapBase {
   map_index_t num_buckets_;
   map_index_t seed_;
   map_index_t index_of_first_non_null_;
+  // Deleted slots in the open-addressing index; always 0 for chaining.
+  map_index_t num_deleted_;
+  bool open_addressing_;
+  // Set by Reserve(): the table is larger than the load alone calls for, so
+  // inserts must not shrink it. Cleared by the next erase or clear.
+  bool reserved_;
+  // The nodes in key order, for deterministic serialization. Built on first
+  // use by SortedNodes() and marked stale on the next insert or erase, so an
+  // unchanged map is sorted only once. The array is reused by later sorts
+  // until the map outgrows it. Written only by the caller that moved
+  // sorted_nodes_state_ to kSortedNodesBuilding, or by a modifying call.
+  enum : uint8_t {
+    kSortedNodesStale,
+    kSortedNodesBuilding,
+    kSortedNodesValid,
+  };
+  mutable NodeBase** sorted_nodes_;
+  mutable map_index_t sorted_nodes_capacity_;
+  mutable std::atomic<uint8_t> sorted_nodes_state_;
   TableEntryPtr* table_;  // an array with num_buckets_ entries
   Allocator alloc_;
 };
@@ -2054,6 +2308,10 @@ struct KeyNode : NodeBase {
 // 6. Except for erase(iterator), any non-const method can reorder iterators.
 // 7. Uses VariantKey when using the Tree representation, which holds all
 //    possible key types as a variant value.
+// 8. Optionally, the buckets can instead form an open-addressing index: each
+//    bucket holds at most one node and a control byte with a tag of the
+//    node's hash, and lookups probe a group of control bytes at a time.
+//    Nodes are still allocated individually, so (2) and (5) hold as well.
 
 template <typename Key>
 class KeyMapBase : public UntypedMapBase {
@@ -2087,6 +2345,7 @@ class KeyMapBase : public UntypedMapBase {
   friend struct MapBenchmarkPeer;
 
   PROTOBUF_NOINLINE void erase_no_destroy(map_index_t b, KeyNode* node) {
+    InvalidateSortedNodes();
     TreeIterator tree_it;
     const bool is_list = revalidate_if_necessary(b, node, &tree_it);
     if (is_list) {
@@ -2094,10 +2353,12 @@ class KeyMapBase : public UntypedMapBase {
       auto* head = TableEntryToNode(table_[b]);
       head = EraseFromLinkedList(node, head);
       table_[b] = NodeToTableEntry(head);
+      if (open_addressing_) EraseFromSlot(b);
     } else {
       EraseFromTree(b, tree_it);
     }
     --num_elements_;
+    reserved_ = false;
     if (PROTOBUF_PREDICT_FALSE(b == index_of_first_non_null_)) {
       while (index_of_first_non_null_ < num_buckets_ &&
              TableEntryIsEmpty(index_of_first_non_null_)) {
@@ -2108,6 +2369,7 @@ class KeyMapBase : public UntypedMapBase {
 
   NodeAndBucket FindHelper(typename TS::ViewType k,
                            TreeIterator* it = nullptr) const {
+    if (open_addressing_) return FindInSlots(k);
     map_index_t b = BucketNumber(k);
     if (TableEntryIsNonEmptyList(b)) {
       auto* node = internal::TableEntryToNode(table_[b]);
@@ -2124,6 +2386,32 @@ class KeyMapBase : public UntypedMapBase {
     return {nullptr, b};
   }
 
+  // FindHelper() for the open-addressing index. If the key is missing, the
+  // returned bucket is the slot where it should be inserted.
+  NodeAndBucket FindInSlots(typename TS::ViewType k) const {
+    if (num_buckets_ == kGlobalEmptyTableSize) return {nullptr, 0};
+    const uint64_t mixed = MixHash(hash_function()(k));
+    const uint8_t tag = CtrlTag(mixed);
+    map_index_t available = num_buckets_;
+    map_index_t g = FirstGroup(mixed);
+    for (map_index_t step = 1;; ++step) {
+      const map_index_t base = g * CtrlGroup::kWidth;
+      const CtrlGroup group(ctrl() + base);
+      for (auto match = group.Match(tag); match != 0; match &= match - 1) {
+        const map_index_t b = base + CtrlGroup::Index(match);
+        auto* node = static_cast<KeyNode*>(TableEntryToNode(table_[b]));
+        ABSL_DCHECK(node != nullptr);
+        if (TS::Equals(node->key(), k)) return {node, b};
+      }
+      if (available == num_buckets_) {
+        const auto slots = group.MatchAvailable();
+        if (slots != 0) available = base + CtrlGroup::Index(slots);
+      }
+      if (group.MatchEmpty() != 0) return {nullptr, available};
+      g = (g + step) & GroupMask();
+    }
+  }
+
   // Insert the given node.
   // If the key is a duplicate, it inserts the new node and returns the old one.
   // Gives ownership to the caller.
@@ -2138,6 +2426,7 @@ class KeyMapBase : public UntypedMapBase {
       p = FindHelper(node->key());
     }
     const map_index_t b = p.bucket;  // bucket number
+    InvalidateSortedNodes();
     InsertUnique(b, node);
     ++num_elements_;
     return to_erase;
@@ -2155,6 +2444,10 @@ class KeyMapBase : public UntypedMapBase {
     // or whatever.  But it's probably cheap enough to recompute that here;
     // it's likely that we're inserting into an empty or short list.
     ABSL_DCHECK(FindHelper(node->key()).node == nullptr);
+    if (open_addressing_) {
+      InsertIntoSlot(b, node, CtrlTag(MixHash(hash_function()(node->key()))));
+      return;
+    }
     if (TableEntryIsEmpty(b)) {
       InsertUniqueInList(b, node);
       index_of_first_non_null_ = (std::min)(index_of_first_non_null_, b);
@@ -2179,19 +2472,25 @@ class KeyMapBase : public UntypedMapBase {
   // policy that sometimes we resize down as well as up, clients can easily
   // keep O(size()) = O(number of buckets) if they want that.
   bool ResizeIfLoadIsOutOfRange(size_type new_size) {
-    const size_type kMaxMapLoadTimes16 = 12;  // controls RAM vs CPU tradeoff
-    const size_type hi_cutoff = num_buckets_ * kMaxMapLoadTimes16 / 16;
+    const size_type max_load_times16 = MaxLoadTimes16(open_addressing_);
+    const size_type hi_cutoff = num_buckets_ * max_load_times16 / 16;
     const size_type lo_cutoff = hi_cutoff / 4;
     // We don't care how many elements are in trees.  If a lot are,
     // we may resize even though there are many empty buckets.  In
     // practice, this seems fine.
-    if (PROTOBUF_PREDICT_FALSE(new_size >= hi_cutoff)) {
+    if (PROTOBUF_PREDICT_FALSE(new_size + num_deleted_ >= hi_cutoff)) {
+      if (new_size < hi_cutoff / 2) {
+        // Mostly deleted slots: rehash in place to reclaim them.
+        Resize(num_buckets_);
+        return true;
+      }
       if (num_buckets_ <= max_size() / 2) {
         Resize(num_buckets_ * 2);
         return true;
       }
     } else if (PROTOBUF_PREDICT_FALSE(new_size <= lo_cutoff &&
-                                      num_buckets_ > kMinTableSize)) {
+                                      num_buckets_ > MinTableSize() &&
+                                      !reserved_)) {
       size_type lg2_of_size_reduction_factor = 1;
       // It's possible we want to shrink a lot here... size() could even be 0.
       // So, estimate how much to shrink by making sure we don't shrink so
@@ -2201,7 +2500,12 @@ class KeyMapBase : public UntypedMapBase {
         ++lg2_of_size_reduction_factor;
       }
       size_type new_num_buckets = std::max<size_type>(
-          kMinTableSize, num_buckets_ >> lg2_of_size_reduction_factor);
+          MinTableSize(), num_buckets_ >> lg2_of_size_reduction_factor);
+      // Unlike chains, open addressing cannot go over its cutoff.
+      while (open_addressing_ &&
+             new_size >= new_num_buckets * max_load_times16 / 16) {
+        new_num_buckets *= 2;
+      }
       if (new_num_buckets != num_buckets_) {
         Resize(new_num_buckets);
         return true;
@@ -2210,21 +2514,42 @@ class KeyMapBase : public UntypedMapBase {
     return false;
   }
 
+  // Grows the table, if needed, so that `n` elements fit without another
+  // resize. Never shrinks it.
+  void Reserve(size_type n) {
+    reserved_ = true;
+    size_type new_num_buckets = TableSize(num_buckets_);
+    while (n >= new_num_buckets * MaxLoadTimes16(open_addressing_) / 16 &&
+           new_num_buckets <= max_size() / 2) {
+      new_num_buckets *= 2;
+    }
+    if (new_num_buckets <= num_buckets_) return;
+    Resize(static_cast<map_index_t>(new_num_buckets));
+  }
+
   // Resize to the given number of buckets.
   void Resize(map_index_t new_num_buckets) {
     if (num_buckets_ == kGlobalEmptyTableSize) {
       // This is the global empty array.
       // Just overwrite with a new one. No need to transfer or free anything.
-      num_buckets_ = index_of_first_non_null_ = kMinTableSize;
+      num_buckets_ = index_of_first_non_null_ = TableSize(new_num_buckets);
       table_ = CreateEmptyTable(num_buckets_);
       seed_ = Seed();
       return;
     }
 
-    ABSL_DCHECK_GE(new_num_buckets, kMinTableSize);
+    ABSL_DCHECK_GE(new_num_buckets, MinTableSize());
+    Rehash(new_num_buckets, open_addressing_);
+  }
+
+  // Moves all nodes into a new table of the given size and layout.
+  void Rehash(map_index_t new_num_buckets, bool open_addressing) {
     const auto old_table = table_;
     const map_index_t old_table_size = num_buckets_;
+    const bool old_open_addressing = open_addressing_;
+    open_addressing_ = open_addressing;
     num_buckets_ = new_num_buckets;
+    num_deleted_ = 0;
     table_ = CreateEmptyTable(num_buckets_);
     const map_index_t start = index_of_first_non_null_;
     index_of_first_non_null_ = num_buckets_;
@@ -2232,17 +2557,45 @@ class KeyMapBase : public UntypedMapBase {
       if (internal::TableEntryIsNonEmptyList(old_table[i])) {
         TransferList(static_cast<KeyNode*>(TableEntryToNode(old_table[i])));
       } else if (internal::TableEntryIsTree(old_table[i])) {
-        this->TransferTree(TableEntryToTree(old_table[i]), NodeToVariantKey);
+        if (open_addressing_) {
+          // The tree's nodes are also linked in a list.
+          TransferList(static_cast<KeyNode*>(
+              this->DestroyTree(TableEntryToTree(old_table[i]))));
+        } else {
+          this->TransferTree(TableEntryToTree(old_table[i]), NodeToVariantKey);
+        }
       }
     }
-    DeleteTable(old_table, old_table_size);
+    DeleteTable(old_table, old_table_size, old_open_addressing);
+  }
+
+  // Switches between chaining and the open-addressing index, moving any
+  // existing nodes over.
+  void SetOpenAddressing(bool enabled) {
+    if (enabled == open_addressing_) return;
+    if (num_buckets_ == kGlobalEmptyTableSize) {
+      open_addressing_ = enabled;
+      return;
+    }
+    map_index_t new_num_buckets =
+        std::max<map_index_t>(num_buckets_, enabled ? kMinOpenTableSize : 0);
+    // Stay below the cutoffs in ResizeIfLoadIsOutOfRange().
+    while (num_elements_ >= new_num_buckets * MaxLoadTimes16(enabled) / 16) {
+      new_num_buckets *= 2;
+    }
+    Rehash(new_num_buckets, enabled);
   }
 
   // Transfer all nodes in the list `node` into `this`.
   void TransferList(KeyNode* node) {
     do {
       auto* next = static_cast<KeyNode*>(node->next);
-      InsertUnique(BucketNumber(node->key()), node);
+      if (open_addressing_) {
+        const uint64_t mixed = MixHash(hash_function()(node->key()));
+        InsertIntoSlot(FindAvailableSlot(mixed), node, CtrlTag(mixed));
+      } else {
+        InsertUnique(BucketNumber(node->key()), node);
+      }
       node = next;
     } while (node != nullptr);
   }
@@ -2372,6 +2725,7 @@ class Map : private internal::KeyMapBase<internal::KeyForBase<Key>> {
  private:
   Map(Arena* arena, const Map& other) : Base(arena) {
     StaticValidityCheck();
+    this->SetOpenAddressing(other.open_addressing());
     insert(other.begin(), other.end());
   }
   static_assert(!std::is_const<mapped_type>::value &&
@@ -2526,6 +2880,18 @@ class Map : private internal::KeyMapBase<internal::KeyForBase<Key>> {
   using Base::empty;
   using Base::size;
 
+  // By default, Map is a chaining hash map whose overlong buckets turn into
+  // trees. Enabling open addressing switches to a flat index that stores one
+  // element per bucket next to a control byte with a tag of its hash, and
+  // looks elements up by matching a whole group of control bytes at once.
+  // That avoids a pointer chase for every collision, which helps large maps,
+  // but there is no tree fallback, so worst-case lookups are linear; keep the
+  // default for maps keyed by untrusted input. Elements stay individually
+  // allocated either way, so pointers and references to them remain valid.
+  // Switching rehashes any existing elements.
+  void set_open_addressing(bool enabled) { this->SetOpenAddressing(enabled); }
+  using Base::open_addressing;
+
   // Element access
   template <typename K = key_type>
   T& operator[](const key_arg<K>& key) ABSL_ATTRIBUTE_LIFETIME_BOUND {
@@ -2680,6 +3046,7 @@ class Map : private internal::KeyMapBase<internal::KeyForBase<Key>> {
   Map& operator=(const Map& other) ABSL_ATTRIBUTE_LIFETIME_BOUND {
     if (this != &other) {
       clear();
+      this->SetOpenAddressing(other.open_addressing());
       insert(other.begin(), other.end());
     }
     return *this;
@@ -2793,6 +3160,7 @@ class Map : private internal::KeyMapBase<internal::KeyForBase<Key>> {
     Arena::CreateInArenaStorage(&node->kv.second, this->alloc_.arena(),
                                 std::forward<Args>(args)...);
 
+    this->InvalidateSortedNodes();
     this->InsertUnique(b, node);
     ++this->num_elements_;
     return std::make_pair(iterator(node, this, b), true);
@@ -2839,11 +3207,21 @@ class Map : private internal::KeyMapBase<internal::KeyForBase<Key>> {
     return TryEmplaceInternal(std::forward<Args>(args)...);
   }
 
+  // The nodes in key order, kept by the map until the next insert or erase.
+  internal::NodeBase* const* SortedNodes() const {
+    return Base::SortedNodes([](internal::NodeBase* a, internal::NodeBase* b) {
+      return static_cast<const Node*>(a)->kv.first <
+             static_cast<const Node*>(b)->kv.first;
+    });
+  }
+
   using Base::arena;
 
   friend class Arena;
   template <typename, typename>
   friend class internal::TypeDefinedMapFieldBase;
+  template <typename>
+  friend class internal::MapSorterBase;
   using InternalArenaConstructable_ = void;
   using DestructorSkippable_ = void;
   template <typename K, typename V>
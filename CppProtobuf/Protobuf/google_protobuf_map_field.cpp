@@ -1247,6 +1247,12 @@ void MapFieldBase::MapEnd(MapIterator* map_iter) const {
   map_iter->iter_ = UntypedMapBase::EndIterator();
 }
 
+void MapFieldBase::SetMapIteratorNode(MapIterator* map_iter,
+                                      NodeBase* node) const {
+  map_iter->iter_ = UntypedMapIterator(node, &GetMapRaw(), 0);
+  SetMapIteratorValue(map_iter);
+}
+
 bool MapFieldBase::EqualIterator(const MapIterator& a,
                                  const MapIterator& b) const {
   return a.iter_.Equals(b.iter_);
@@ -1387,6 +1393,75 @@ void MapFieldBase::SyncRepeatedFieldWithMap() const {
   }
 }
 
+namespace {
+
+void SetMapEntryKey(const Reflection* reflection, Message* entry,
+                    const FieldDescriptor* key_des, const MapKey& map_key) {
+  switch (key_des->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_STRING:
+      reflection->SetString(entry, key_des, map_key.GetStringValue());
+      break;
+    case FieldDescriptor::CPPTYPE_INT64:
+      reflection->SetInt64(entry, key_des, map_key.GetInt64Value());
+      break;
+    case FieldDescriptor::CPPTYPE_INT32:
+      reflection->SetInt32(entry, key_des, map_key.GetInt32Value());
+      break;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      reflection->SetUInt64(entry, key_des, map_key.GetUInt64Value());
+      break;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      reflection->SetUInt32(entry, key_des, map_key.GetUInt32Value());
+      break;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      reflection->SetBool(entry, key_des, map_key.GetBoolValue());
+      break;
+    default:
+      PROTOBUF_ASSUME(false);
+  }
+}
+
+void SetMapEntryValue(const Reflection* reflection, Message* entry,
+                      const FieldDescriptor* val_des,
+                      const MapValueConstRef& map_val) {
+  switch (val_des->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_STRING:
+      reflection->SetString(entry, val_des, map_val.GetStringValue());
+      break;
+    case FieldDescriptor::CPPTYPE_INT64:
+      reflection->SetInt64(entry, val_des, map_val.GetInt64Value());
+      break;
+    case FieldDescriptor::CPPTYPE_INT32:
+      reflection->SetInt32(entry, val_des, map_val.GetInt32Value());
+      break;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      reflection->SetUInt64(entry, val_des, map_val.GetUInt64Value());
+      break;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      reflection->SetUInt32(entry, val_des, map_val.GetUInt32Value());
+      break;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      reflection->SetBool(entry, val_des, map_val.GetBoolValue());
+      break;
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      reflection->SetDouble(entry, val_des, map_val.GetDoubleValue());
+      break;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      reflection->SetFloat(entry, val_des, map_val.GetFloatValue());
+      break;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      reflection->SetEnumValue(entry, val_des, map_val.GetEnumValue());
+      break;
+    case FieldDescriptor::CPPTYPE_MESSAGE: {
+      const Message& message = map_val.GetMessageValue();
+      reflection->MutableMessage(entry, val_des)->CopyFrom(message);
+      break;
+    }
+  }
+}
+
+}  // namespace
+
 void MapFieldBase::SyncRepeatedFieldWithMapNoLock() {
   const Message* prototype = GetPrototype();
   const Reflection* reflection = prototype->GetReflection();
@@ -1407,65 +1482,8 @@ void MapFieldBase::SyncRepeatedFieldWithMapNoLock() {
   for (; !EqualIterator(it, end); IncreaseIterator(&it)) {
     Message* new_entry = prototype->New(arena());
     rep.AddAllocated(new_entry);
-    const MapKey& map_key = it.GetKey();
-    switch (key_des->cpp_type()) {
-      case FieldDescriptor::CPPTYPE_STRING:
-        reflection->SetString(new_entry, key_des, map_key.GetStringValue());
-        break;
-      case FieldDescriptor::CPPTYPE_INT64:
-        reflection->SetInt64(new_entry, key_des, map_key.GetInt64Value());
-        break;
-      case FieldDescriptor::CPPTYPE_INT32:
-        reflection->SetInt32(new_entry, key_des, map_key.GetInt32Value());
-        break;
-      case FieldDescriptor::CPPTYPE_UINT64:
-        reflection->SetUInt64(new_entry, key_des, map_key.GetUInt64Value());
-        break;
-      case FieldDescriptor::CPPTYPE_UINT32:
-        reflection->SetUInt32(new_entry, key_des, map_key.GetUInt32Value());
-        break;
-      case FieldDescriptor::CPPTYPE_BOOL:
-        reflection->SetBool(new_entry, key_des, map_key.GetBoolValue());
-        break;
-      default:
-        PROTOBUF_ASSUME(false);
-    }
-
-    const MapValueRef& map_val = it.GetValueRef();
-    switch (val_des->cpp_type()) {
-      case FieldDescriptor::CPPTYPE_STRING:
-        reflection->SetString(new_entry, val_des, map_val.GetStringValue());
-        break;
-      case FieldDescriptor::CPPTYPE_INT64:
-        reflection->SetInt64(new_entry, val_des, map_val.GetInt64Value());
-        break;
-      case FieldDescriptor::CPPTYPE_INT32:
-        reflection->SetInt32(new_entry, val_des, map_val.GetInt32Value());
-        break;
-      case FieldDescriptor::CPPTYPE_UINT64:
-        reflection->SetUInt64(new_entry, val_des, map_val.GetUInt64Value());
-        break;
-      case FieldDescriptor::CPPTYPE_UINT32:
-        reflection->SetUInt32(new_entry, val_des, map_val.GetUInt32Value());
-        break;
-      case FieldDescriptor::CPPTYPE_BOOL:
-        reflection->SetBool(new_entry, val_des, map_val.GetBoolValue());
-        break;
-      case FieldDescriptor::CPPTYPE_DOUBLE:
-        reflection->SetDouble(new_entry, val_des, map_val.GetDoubleValue());
-        break;
-      case FieldDescriptor::CPPTYPE_FLOAT:
-        reflection->SetFloat(new_entry, val_des, map_val.GetFloatValue());
-        break;
-      case FieldDescriptor::CPPTYPE_ENUM:
-        reflection->SetEnumValue(new_entry, val_des, map_val.GetEnumValue());
-        break;
-      case FieldDescriptor::CPPTYPE_MESSAGE: {
-        const Message& message = map_val.GetMessageValue();
-        reflection->MutableMessage(new_entry, val_des)->CopyFrom(message);
-        break;
-      }
-    }
+    SetMapEntryKey(reflection, new_entry, key_des, it.GetKey());
+    SetMapEntryValue(reflection, new_entry, val_des, it.GetValueRef());
   }
 }
 
@@ -1578,6 +1596,11 @@ bool MapFieldBase::InsertOrLookupMapValue(const MapKey& map_key,
   return InsertOrLookupMapValueNoSync(map_key, val);
 }
 
+void MapFieldBase::Reserve(size_t n) {
+  SyncMapWithRepeatedField();
+  vtable()->reserve_no_sync(*this, n);
+}
+
 // ------------------DynamicMapField------------------
 DynamicMapField::DynamicMapField(const Message* default_entry)
     : DynamicMapField::TypeDefinedMapFieldBase(&kVTable),
@@ -1778,6 +1801,72 @@ size_t DynamicMapField::SpaceUsedExcludingSelfNoLockImpl(
   return size;
 }
 
+MapEntryReader::MapEntryReader(const Message& message,
+                               const FieldDescriptor* field, bool sorted)
+    : message_(message),
+      field_(field),
+      map_(message.GetReflection()->GetMapData(message, field)),
+      // Unlike MapFieldBase::size(), FieldSize() syncs neither side.
+      size_(message.GetReflection()->FieldSize(message, field)),
+      iter_(const_cast<Message*>(&message), field) {
+  if (!sorted && map_->IsRepeatedFieldValid()) {
+    read_repeated_ = true;
+    return;
+  }
+  if (sorted) {
+    sorted_nodes_ = map_->SortedNodes();
+  } else {
+    map_->MapBegin(&iter_);
+  }
+  entry_.reset(message.GetReflection()
+                   ->GetMessageFactory()
+                   ->GetPrototype(field->message_type())
+                   ->New());
+}
+
+MapEntryReader::~MapEntryReader() { ReturnLentValue(); }
+
+const Message* MapEntryReader::Next() {
+  if (index_ == size_) return nullptr;
+  const int index = index_++;
+  if (read_repeated_) {
+    return &message_.GetReflection()->GetRepeatedMessage(message_, field_,
+                                                         index);
+  }
+  if (sorted_nodes_ != nullptr) {
+    map_->SetMapIteratorNode(&iter_, sorted_nodes_[index]);
+  } else if (index > 0) {
+    ++iter_;
+  }
+  FillEntry();
+  return entry_.get();
+}
+
+void MapEntryReader::FillEntry() {
+  const Reflection* reflection = entry_->GetReflection();
+  const FieldDescriptor* key_des = field_->message_type()->map_key();
+  const FieldDescriptor* val_des = field_->message_type()->map_value();
+  SetMapEntryKey(reflection, entry_.get(), key_des, iter_.GetKey());
+  if (val_des->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+    SetMapEntryValue(reflection, entry_.get(), val_des, iter_.GetValueRef());
+    return;
+  }
+  // Lend the value to the entry; it is taken back before the entry is reused
+  // or destroyed, so the map never sees the entry own it.
+  ReturnLentValue();
+  reflection->UnsafeArenaSetAllocatedMessage(
+      entry_.get(),
+      const_cast<Message*>(&iter_.GetValueRef().GetMessageValue()), val_des);
+  value_lent_ = true;
+}
+
+void MapEntryReader::ReturnLentValue() {
+  if (!value_lent_) return;
+  entry_->GetReflection()->UnsafeArenaReleaseMessage(
+      entry_.get(), field_->message_type()->map_value());
+  value_lent_ = false;
+}
+
 }  // namespace internal
 }  // namespace protobuf
 }  // namespace google
@@ -10,6 +10,7 @@
 
 #include <atomic>
 #include <functional>
+#include <memory>
 #include <type_traits>
 
 #include <CppAbseil/absl_synchronization_mutex.hpp>
@@ -1498,6 +1499,8 @@ class PROTOBUF_EXPORT MapFieldBase : public MapFieldBaseForParse {
                                      MapValueRef* val);
 
     void (*clear_map_no_sync)(MapFieldBase& map);
+    void (*reserve_no_sync)(MapFieldBase& map, size_t n);
+    NodeBase* const* (*sorted_nodes)(const MapFieldBase& map);
     void (*merge_from)(MapFieldBase& map, const MapFieldBase& other);
     void (*swap)(MapFieldBase& lhs, MapFieldBase& rhs);
     void (*unsafe_shallow_swap)(MapFieldBase& lhs, MapFieldBase& rhs);
@@ -1514,6 +1517,8 @@ class PROTOBUF_EXPORT MapFieldBase : public MapFieldBaseForParse {
     out.set_map_iterator_value = &T::SetMapIteratorValueImpl;
     out.insert_or_lookup_no_sync = &T::InsertOrLookupMapValueNoSyncImpl;
     out.clear_map_no_sync = &T::ClearMapNoSyncImpl;
+    out.reserve_no_sync = &T::ReserveNoSyncImpl;
+    out.sorted_nodes = &T::SortedNodesImpl;
     out.merge_from = &T::MergeFromImpl;
     out.swap = &T::SwapImpl;
     out.unsafe_shallow_swap = &T::UnsafeShallowSwapImpl;
@@ -1543,6 +1548,10 @@ class PROTOBUF_EXPORT MapFieldBase : public MapFieldBaseForParse {
 
   bool InsertOrLookupMapValue(const MapKey& map_key, MapValueRef* val);
 
+  // Makes room for `n` elements in the map, e.g. before parsing that many
+  // entries.
+  void Reserve(size_t n);
+
   // Returns whether changes to the map are reflected in the repeated field.
   bool IsRepeatedFieldValid() const;
   // Insures operations after won't get executed before calling this.
@@ -1568,6 +1577,15 @@ class PROTOBUF_EXPORT MapFieldBase : public MapFieldBaseForParse {
   void MapEnd(MapIterator* map_iter) const;
   bool EqualIterator(const MapIterator& a, const MapIterator& b) const;
 
+  // Returns the size() nodes of the map in key order, for deterministic
+  // serialization. The map keeps the order until its next insert or erase.
+  NodeBase* const* SortedNodes() const {
+    SyncMapWithRepeatedField();
+    return vtable()->sorted_nodes(*this);
+  }
+  // Points `map_iter` at `node`, one of the nodes from SortedNodes().
+  void SetMapIteratorNode(MapIterator* map_iter, NodeBase* node) const;
+
   // Returns the number of bytes used by the repeated field, excluding
   // sizeof(*this)
   size_t SpaceUsedExcludingSelfLong() const;
@@ -1776,6 +1794,14 @@ class TypeDefinedMapFieldBase : public MapFieldBase {
     static_cast<TypeDefinedMapFieldBase&>(map).map_.clear();
   }
 
+  static void ReserveNoSyncImpl(MapFieldBase& map, size_t n) {
+    static_cast<TypeDefinedMapFieldBase&>(map).map_.Reserve(n);
+  }
+
+  static NodeBase* const* SortedNodesImpl(const MapFieldBase& map) {
+    return static_cast<const TypeDefinedMapFieldBase&>(map).map_.SortedNodes();
+  }
+
   void InternalSwap(TypeDefinedMapFieldBase* other);
 
  protected:
@@ -2153,6 +2179,46 @@ class PROTOBUF_EXPORT MapIterator {
 };
 
 namespace internal {
+
+// Reads the elements of a map field as map entry messages straight from its
+// Map, so that reflection-based tools (TextFormat, JSON, MessageDifferencer)
+// never make the field build its repeated representation. When the repeated
+// field is already up to date and no order is requested, its entries are
+// returned as is. Otherwise one entry message is reused for every element, and
+// a message value is lent to it instead of being copied: the entry returned by
+// Next() is only valid until the following call.
+class PROTOBUF_EXPORT MapEntryReader {
+ public:
+  // With `sorted`, elements come in key order (see MapFieldBase::SortedNodes).
+  MapEntryReader(const Message& message, const FieldDescriptor* field,
+                 bool sorted);
+  MapEntryReader(const MapEntryReader&) = delete;
+  MapEntryReader& operator=(const MapEntryReader&) = delete;
+  ~MapEntryReader();
+
+  int size() const { return size_; }
+
+  // Returns the next element, or nullptr after the last one.
+  const Message* Next();
+
+ private:
+  void FillEntry();
+  void ReturnLentValue();
+
+  const Message& message_;
+  const FieldDescriptor* field_;
+  const MapFieldBase* map_;
+  int size_;
+  int index_ = 0;
+  // Set when the repeated field is read directly.
+  bool read_repeated_ = false;
+  // Set when elements come in key order.
+  NodeBase* const* sorted_nodes_ = nullptr;
+  MapIterator iter_;
+  std::unique_ptr<Message> entry_;
+  bool value_lent_ = false;
+};
+
 template <>
 struct is_internal_map_value_type<class MapValueConstRef> : std::true_type {};
 template <>
@@ -90,6 +90,7 @@
 #include <iosfwd>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <CppProtobuf/google_protobuf_stubs_common.hpp>
@@ -102,6 +103,7 @@
 #include <CppAbseil/absl_strings_cord.hpp>
 #include <CppAbseil/absl_strings_string_view.hpp>
 #include <CppProtobuf/google_protobuf_arena.hpp>
+#include <CppProtobuf/google_protobuf_arenastring.hpp>
 #include <CppProtobuf/google_protobuf_descriptor.hpp>
 #include <CppProtobuf/google_protobuf_generated_message_reflection.hpp>
 #include <CppProtobuf/google_protobuf_generated_message_tctable_decl.hpp>
@@ -1306,6 +1308,7 @@ namespace protobuf {
 // Defined in this file.
 class Message;
 class Reflection;
+class FieldAccessor;
 class MessageFactory;
 
 // Defined in other files.
@@ -1322,6 +1325,7 @@ namespace internal {
 struct FuzzPeer;
 struct DescriptorTable;
 class MapFieldBase;
+class MapEntryReader;
 class MessageUtil;
 class SwapFieldHelper;
 class CachedSize;
@@ -1359,7 +1363,6 @@ class MessageDifferencer;
 namespace internal {
 class ReflectionAccessor;      // message.cc
 class ReflectionOps;           // reflection_ops.h
-class MapKeySorter;            // wire_format.cc
 class WireFormat;              // wire_format.h
 class MapFieldReflectionTest;  // map_test.cc
 }  // namespace internal
@@ -2056,6 +2059,14 @@ class PROTOBUF_EXPORT Reflection final {
     return MutableRepeatedPtrFieldInternal<T>(msg, d);
   }
 
+  // Field accessors -----------------------------------------------------------
+
+  // Returns a FieldAccessor for a singular, non-message field of this message
+  // type.  The accessor does the descriptor and layout lookups once, which the
+  // Get*() and Set*() methods above repeat on every call.  Code that touches
+  // the same field of many messages should fetch the accessor up front.
+  FieldAccessor GetFieldAccessor(const FieldDescriptor* field) const;
+
   // Extensions ----------------------------------------------------------------
 
   // Try to find an extension of this message type by fully-qualified field
@@ -2241,7 +2252,6 @@ class PROTOBUF_EXPORT Reflection final {
 #define GOOGLE_PROTOBUF_HAS_CEL_MAP_REFLECTION_FRIEND
   friend class expr::CelMapReflectionFriend;
   friend class internal::MapFieldReflectionTest;
-  friend class internal::MapKeySorter;
   friend class internal::MessageUtil;
   friend class internal::WireFormat;
   friend class internal::ReflectionOps;
@@ -2249,6 +2259,8 @@ class PROTOBUF_EXPORT Reflection final {
   friend struct internal::FuzzPeer;
   // Needed for implementing text format for map.
   friend class internal::MapFieldPrinterHelper;
+  // Reads map fields for reflection-based tools without syncing them.
+  friend class internal::MapEntryReader;
 
   Reflection(const Descriptor* descriptor,
              const internal::ReflectionSchema& schema,
@@ -2460,6 +2472,212 @@ class PROTOBUF_EXPORT Reflection final {
                                              internal::ParseContext* ctx);
 };
 
+// Reads and writes one singular, non-message field of messages of one type.
+// Obtain one with Reflection::GetFieldAccessor().
+//
+// The accessor caches where the field and its has-bit or oneof case live in
+// the message, so its getters and setters are a few loads and stores.  Fields
+// that are not stored directly in the message (extensions, split, inlined and
+// Cord fields) go through Reflection instead, as do writes that first have to
+// clear another member of a oneof.  Every method works for every such field.
+//
+// An accessor is a small value: it can be copied and used from several
+// threads, and it stays valid as long as the Reflection it came from.  As with
+// Reflection, messages must be of the field's containing type and the typed
+// methods must match the field's cpp type.
+//
+// Example:
+//   FieldAccessor id = reflection->GetFieldAccessor(id_field);
+//   for (const Message* message : messages) sum += id.GetInt64(*message);
+class PROTOBUF_EXPORT FieldAccessor final {
+ public:
+  const FieldDescriptor* field() const { return field_; }
+
+  // Same as Reflection::HasField().
+  bool Has(const Message& message) const;
+
+  // Same as the Reflection getters of the same names.
+  int32_t GetInt32(const Message& message) const {
+    return Get<int32_t>(message, &Reflection::GetInt32);
+  }
+  int64_t GetInt64(const Message& message) const {
+    return Get<int64_t>(message, &Reflection::GetInt64);
+  }
+  uint32_t GetUInt32(const Message& message) const {
+    return Get<uint32_t>(message, &Reflection::GetUInt32);
+  }
+  uint64_t GetUInt64(const Message& message) const {
+    return Get<uint64_t>(message, &Reflection::GetUInt64);
+  }
+  float GetFloat(const Message& message) const {
+    return Get<float>(message, &Reflection::GetFloat);
+  }
+  double GetDouble(const Message& message) const {
+    return Get<double>(message, &Reflection::GetDouble);
+  }
+  bool GetBool(const Message& message) const {
+    return Get<bool>(message, &Reflection::GetBool);
+  }
+  int GetEnumValue(const Message& message) const {
+    return Get<int>(message, &Reflection::GetEnumValue);
+  }
+  std::string GetString(const Message& message) const;
+  const std::string& GetStringReference(const Message& message,
+                                        std::string* scratch) const;
+
+  // Same as the Reflection setters of the same names.
+  void SetInt32(Message* message, int32_t value) const {
+    Set<int32_t>(message, value, &Reflection::SetInt32);
+  }
+  void SetInt64(Message* message, int64_t value) const {
+    Set<int64_t>(message, value, &Reflection::SetInt64);
+  }
+  void SetUInt32(Message* message, uint32_t value) const {
+    Set<uint32_t>(message, value, &Reflection::SetUInt32);
+  }
+  void SetUInt64(Message* message, uint64_t value) const {
+    Set<uint64_t>(message, value, &Reflection::SetUInt64);
+  }
+  void SetFloat(Message* message, float value) const {
+    Set<float>(message, value, &Reflection::SetFloat);
+  }
+  void SetDouble(Message* message, double value) const {
+    Set<double>(message, value, &Reflection::SetDouble);
+  }
+  void SetBool(Message* message, bool value) const {
+    Set<bool>(message, value, &Reflection::SetBool);
+  }
+  void SetEnumValue(Message* message, int value) const;
+  void SetString(Message* message, std::string value) const;
+
+ private:
+  friend class Reflection;
+
+  FieldAccessor(const Reflection* reflection, const FieldDescriptor* field)
+      : reflection_(reflection), field_(field) {}
+
+  // True if the value can be read and written at offset_.  For a member of a
+  // oneof that also requires the oneof to hold this field.
+  bool IsDirect(const Message& message) const {
+    return direct_ &&
+           (oneof_case_offset_ == 0 ||
+            internal::GetConstRefAtOffset<uint32_t>(
+                message, oneof_case_offset_) == number_);
+  }
+
+  void SetHasBit(Message* message) const {
+    if (has_bit_mask_ != 0) {
+      *internal::GetPointerAtOffset<uint32_t>(message, has_bit_offset_) |=
+          has_bit_mask_;
+    }
+  }
+
+  template <typename T>
+  T Get(const Message& message,
+        T (Reflection::*slow)(const Message&, const FieldDescriptor*)
+            const) const {
+    ABSL_DCHECK_EQ(message.GetReflection(), reflection_);
+    if (PROTOBUF_PREDICT_FALSE(!IsDirect(message))) {
+      return (reflection_->*slow)(message, field_);
+    }
+    return internal::GetConstRefAtOffset<T>(message, offset_);
+  }
+
+  template <typename T>
+  void Set(Message* message, T value,
+           void (Reflection::*slow)(Message*, const FieldDescriptor*, T)
+               const) const {
+    ABSL_DCHECK_EQ(message->GetReflection(), reflection_);
+    if (PROTOBUF_PREDICT_FALSE(!IsDirect(*message))) {
+      return (reflection_->*slow)(message, field_, value);
+    }
+    *internal::GetPointerAtOffset<T>(message, offset_) = value;
+    SetHasBit(message);
+  }
+
+  const Reflection* reflection_;
+  const FieldDescriptor* field_;
+  // Set when the value is stored in the message itself at offset_.
+  bool direct_ = false;
+  // Set for closed enums, whose unknown values go to the unknown fields.
+  bool closed_enum_ = false;
+  // Size of a scalar value, or 0 for strings.  Used by Has() for fields
+  // without presence, which are set when their value is non-zero.
+  uint8_t value_size_ = 0;
+  uint32_t offset_ = 0;
+  uint32_t number_ = 0;
+  // Offset of the oneof case, or 0 if the field is not in a real oneof.
+  uint32_t oneof_case_offset_ = 0;
+  // Offset of the has-bit word, and the bit, if the field has one.
+  uint32_t has_bit_offset_ = 0;
+  uint32_t has_bit_mask_ = 0;
+};
+
+inline bool FieldAccessor::Has(const Message& message) const {
+  ABSL_DCHECK_EQ(message.GetReflection(), reflection_);
+  if (PROTOBUF_PREDICT_FALSE(!direct_)) {
+    return reflection_->HasField(message, field_);
+  }
+  if (oneof_case_offset_ != 0) {
+    return internal::GetConstRefAtOffset<uint32_t>(
+               message, oneof_case_offset_) == number_;
+  }
+  if (has_bit_mask_ != 0) {
+    return (internal::GetConstRefAtOffset<uint32_t>(message, has_bit_offset_) &
+            has_bit_mask_) != 0;
+  }
+  switch (value_size_) {
+    case 1:
+      return internal::GetConstRefAtOffset<uint8_t>(message, offset_) != 0;
+    case 4:
+      return internal::GetConstRefAtOffset<uint32_t>(message, offset_) != 0;
+    case 8:
+      return internal::GetConstRefAtOffset<uint64_t>(message, offset_) != 0;
+    default:
+      return !internal::GetConstRefAtOffset<internal::ArenaStringPtr>(message,
+                                                                      offset_)
+                  .Get()
+                  .empty();
+  }
+}
+
+inline std::string FieldAccessor::GetString(const Message& message) const {
+  ABSL_DCHECK_EQ(message.GetReflection(), reflection_);
+  if (PROTOBUF_PREDICT_FALSE(!IsDirect(message))) {
+    return reflection_->GetString(message, field_);
+  }
+  return GetStringReference(message, nullptr);
+}
+
+inline const std::string& FieldAccessor::GetStringReference(
+    const Message& message, std::string* scratch) const {
+  ABSL_DCHECK_EQ(message.GetReflection(), reflection_);
+  if (PROTOBUF_PREDICT_FALSE(!IsDirect(message))) {
+    return reflection_->GetStringReference(message, field_, scratch);
+  }
+  const auto& str =
+      internal::GetConstRefAtOffset<internal::ArenaStringPtr>(message, offset_);
+  return str.IsDefault() ? field_->default_value_string() : str.Get();
+}
+
+inline void FieldAccessor::SetEnumValue(Message* message, int value) const {
+  if (PROTOBUF_PREDICT_FALSE(closed_enum_)) {
+    return reflection_->SetEnumValue(message, field_, value);
+  }
+  Set<int>(message, value, &Reflection::SetEnumValue);
+}
+
+inline void FieldAccessor::SetString(Message* message,
+                                     std::string value) const {
+  ABSL_DCHECK_EQ(message->GetReflection(), reflection_);
+  if (PROTOBUF_PREDICT_FALSE(!IsDirect(*message))) {
+    return reflection_->SetString(message, field_, std::move(value));
+  }
+  internal::GetPointerAtOffset<internal::ArenaStringPtr>(message, offset_)
+      ->Set(std::move(value), message->GetArena());
+  SetHasBit(message);
+}
+
 // Abstract interface for a factory for message objects.
 //
 // The thread safety for this class is implementation dependent, see comments
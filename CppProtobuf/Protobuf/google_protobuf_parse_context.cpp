@@ -1367,6 +1367,114 @@ const char* EpsCopyInputStream::SkipFallback(const char* ptr, int size) {
   return AppendSize(ptr, size, [](const char* /*p*/, int /*s*/) {});
 }
 
+namespace {
+
+// Decodes the varint at `p` without reading at or past `end`. Returns nullptr
+// if the varint does not end before `end` or is longer than 10 bytes.
+const char* ReadVarintBefore(const char* p, const char* end, uint64_t* value) {
+  uint64_t result = 0;
+  for (int shift = 0; p < end && shift < 70; shift += 7) {
+    const uint8_t byte = static_cast<uint8_t>(*p++);
+    result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if (byte < 0x80) {
+      *value = result;
+      return p;
+    }
+  }
+  return nullptr;
+}
+
+// Counts the fields with `tag` that follow each other starting at `ptr`, just
+// past the first tag, and ending before `end`. `skip_value(ptr, end, wide)`
+// returns the end of the value at `ptr`, or nullptr if it is malformed; `wide`
+// tells it whether it may read up to 16 bytes from `ptr`.
+template <typename SkipValue>
+int CountRun(const char* ptr, const char* end, uint32_t tag,
+             SkipValue skip_value) {
+  // Compare the encoded tag bytes instead of decoding every tag.
+  uint64_t tag_bytes = 0;
+  int tag_size = 0;
+  for (uint32_t rest = tag; rest != 0 || tag_size == 0; rest >>= 7) {
+    const uint64_t byte = (rest & 0x7F) | (rest >= 0x80 ? 0x80 : 0);
+    tag_bytes |= byte << (8 * tag_size++);
+  }
+  const uint64_t tag_mask = (uint64_t{1} << (8 * tag_size)) - 1;
+
+  int count = 0;
+  while (ptr < end) {
+    ptr = skip_value(ptr, end, end - ptr > 16);
+    if (ptr == nullptr || ptr > end) break;
+    ++count;
+    if (end - ptr >= static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+      if ((UnalignedLoad<uint64_t>(ptr) & tag_mask) != tag_bytes) break;
+      ptr += tag_size;
+    } else {
+      uint64_t next_tag;
+      ptr = ReadVarintBefore(ptr, end, &next_tag);
+      if (ptr == nullptr || next_tag != tag) break;
+    }
+  }
+  return count;
+}
+
+}  // namespace
+
+int EpsCopyInputStream::CountFieldRun(const char* ptr, uint32_t tag) const {
+  // The slop bytes past buffer_end_ hold valid data up to the current limit.
+  const char* const end = buffer_end_ + std::min<int>(limit_, kSlopBytes);
+  switch (WireFormatLite::GetTagWireType(tag)) {
+    case WireFormatLite::WIRETYPE_VARINT:
+      return CountRun(ptr, end, tag, [](const char* p, const char* end,
+                                        bool wide) {
+        if (wide) {
+          const uint64_t last_bytes =
+              ~UnalignedLoad<uint64_t>(p) & 0x8080808080808080;
+          if (last_bytes != 0) return p + absl::countr_zero(last_bytes) / 8 + 1;
+        }
+        uint64_t value;
+        return ReadVarintBefore(p, end, &value);
+      });
+    case WireFormatLite::WIRETYPE_FIXED64:
+      return CountRun(ptr, end, tag, [](const char* p, const char*, bool) {
+        return p + sizeof(uint64_t);
+      });
+    case WireFormatLite::WIRETYPE_FIXED32:
+      return CountRun(ptr, end, tag, [](const char* p, const char*, bool) {
+        return p + sizeof(uint32_t);
+      });
+    case WireFormatLite::WIRETYPE_LENGTH_DELIMITED:
+      return CountRun(ptr, end, tag, [](const char* p, const char* end,
+                                        bool wide) -> const char* {
+        uint64_t size;
+        if (wide) {
+          size = ReadSize(&p);
+        } else {
+          p = ReadVarintBefore(p, end, &size);
+        }
+        if (p == nullptr || size > static_cast<uint64_t>(end - p)) {
+          return nullptr;
+        }
+        return p + size;
+      });
+    default:
+      return 0;
+  }
+}
+
+int EpsCopyInputStream::CountPackedVarints(const char* ptr) const {
+  const char* const end = buffer_end_ + std::min<int>(limit_, kSlopBytes);
+  uint64_t size;
+  ptr = ReadVarintBefore(ptr, end, &size);
+  if (ptr == nullptr) return 0;
+  const char* const last = ptr + std::min<uint64_t>(size, end - ptr);
+  int count = 0;
+  for (; ptr < last; ++ptr) {
+    // Every varint ends with the one byte that has no continuation bit.
+    count += static_cast<uint8_t>(*ptr) < 0x80;
+  }
+  return count;
+}
+
 const char* EpsCopyInputStream::ReadStringFallback(const char* ptr, int size,
                                                    std::string* str) {
   str->clear();
@@ -1437,6 +1437,17 @@ class PROTOBUF_EXPORT EpsCopyInputStream {
   // Returns true if more data is available, if false is returned one has to
   // call Done for further checks.
   bool DataAvailable(const char* ptr) { return ptr < limit_end_; }
+  // Counts the fields with tag `tag` that follow each other back to back
+  // starting at `ptr`, which points just past the first tag. Groups are not
+  // counted. Only looks at data already in the buffer, so the result may be
+  // short of the real count; it is meant for presizing containers. Reserving
+  // room for a run of map entries or repeated elements once, before parsing
+  // it, keeps a large container from being regrown or rehashed over and over
+  // while it is being parsed.
+  int CountFieldRun(const char* ptr, uint32_t tag) const;
+  // Counts the varints of the packed field whose length prefix is at `ptr`.
+  // Like CountFieldRun(), only looks at data already in the buffer.
+  int CountPackedVarints(const char* ptr) const;
 
  protected:
   // Returns true is limit (either an explicit limit or end of stream) is
@@ -1631,6 +1642,8 @@ class PROTOBUF_EXPORT ParseContext : public EpsCopyInputStream {
   struct Data {
     const DescriptorPool* pool = nullptr;
     MessageFactory* factory = nullptr;
+    // See io::CodedInputStream::SetPresizeRepeatedFields().
+    bool presize_repeated_fields = false;
   };
 
   template <typename... T>
@@ -20,6 +20,8 @@
 #include "google_protobuf_descriptor.pb.hpp"
 #include "google_protobuf_map_field.hpp"
 #include "google_protobuf_map_field_inl.hpp"
+#include "google_protobuf_repeated_field.hpp"
+#include "google_protobuf_repeated_ptr_field.hpp"
 #include "google_protobuf_unknown_field_set.hpp"
 
 // Must be included last.
@@ -1223,6 +1225,53 @@ static const Reflection* GetReflectionOrDie(const Message& m) {
   return r;
 }
 
+// Appends all elements of a repeated scalar or string field at once. The
+// containers of such fields have the same type in generated and dynamic
+// messages and in extension sets, so this works across reflection
+// implementations. Returns false for fields that have to be merged element by
+// element.
+bool ReflectionOps::MergeRepeatedFieldInBulk(const Message& from,
+                                             const Reflection* from_reflection,
+                                             Message* to,
+                                             const Reflection* to_reflection,
+                                             const FieldDescriptor* field) {
+  const FieldDescriptor::CppType cpp_type = field->cpp_type();
+  switch (cpp_type) {
+#define HANDLE_TYPE(CPPTYPE, TYPE)                                         \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                                 \
+    static_cast<RepeatedField<TYPE>*>(                                     \
+        to_reflection->MutableRawRepeatedField(to, field, cpp_type, -1,    \
+                                               nullptr))                   \
+        ->MergeFrom(*static_cast<const RepeatedField<TYPE>*>(              \
+            from_reflection->GetRawRepeatedField(from, field, cpp_type,    \
+                                                 -1, nullptr)));           \
+    return true;
+
+    HANDLE_TYPE(INT32, int32_t);
+    HANDLE_TYPE(INT64, int64_t);
+    HANDLE_TYPE(UINT32, uint32_t);
+    HANDLE_TYPE(UINT64, uint64_t);
+    HANDLE_TYPE(FLOAT, float);
+    HANDLE_TYPE(DOUBLE, double);
+    HANDLE_TYPE(BOOL, bool);
+    HANDLE_TYPE(ENUM, int);
+#undef HANDLE_TYPE
+
+    case FieldDescriptor::CPPTYPE_STRING:
+      static_cast<RepeatedPtrField<std::string>*>(
+          to_reflection->MutableRawRepeatedField(to, field, cpp_type, -1,
+                                                 nullptr))
+          ->MergeFrom(*static_cast<const RepeatedPtrField<std::string>*>(
+              from_reflection->GetRawRepeatedField(from, field, cpp_type, -1,
+                                                   nullptr)));
+      return true;
+
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      break;
+  }
+  return false;
+}
+
 void ReflectionOps::Copy(const Message& from, Message* to) {
   if (&from == to) return;
   Clear(to);
@@ -1263,6 +1312,10 @@ void ReflectionOps::Merge(const Message& from, Message* to) {
           continue;
         }
       }
+      if (MergeRepeatedFieldInBulk(from, from_reflection, to, to_reflection,
+                                   field)) {
+        continue;
+      }
       int count = from_reflection->FieldSize(from, field);
       for (int j = 0; j < count; j++) {
         switch (field->cpp_type()) {
@@ -1238,6 +1238,13 @@ class PROTOBUF_EXPORT ReflectionOps {
   static void FindInitializationErrors(const Message& message,
                                        const std::string& prefix,
                                        std::vector<std::string>* errors);
+
+ private:
+  static bool MergeRepeatedFieldInBulk(const Message& from,
+                                       const Reflection* from_reflection,
+                                       Message* to,
+                                       const Reflection* to_reflection,
+                                       const FieldDescriptor* field);
 };
 
 }  // namespace internal
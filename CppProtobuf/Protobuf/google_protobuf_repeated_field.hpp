@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <limits>
 #include <memory>
@@ -1507,12 +1508,53 @@ class RepeatedField final
   static constexpr int kInitialSize = 0;
   static PROTOBUF_CONSTEXPR const size_t kRepHeaderSize = sizeof(Rep);
 
+  // Small fields keep their elements inline, in the bytes that otherwise hold
+  // the size and capacity of the Rep ("SOO" mode). In that mode the low bits of
+  // `arena_or_elements_` hold the size and the rest holds the arena; once the
+  // field outgrows the inline storage it holds the elements of a Rep, tagged
+  // with kNotSooBit.
+  static constexpr size_t kSooCapacityBytes = 2 * sizeof(int);
+  static constexpr uintptr_t kSooSizeMask = 3;
+  static constexpr uintptr_t kNotSooBit = 4;
+  static constexpr uintptr_t kSooTagMask = kSooSizeMask | kNotSooBit;
+  static_assert(alignof(Arena) > kSooTagMask,
+                "The arena pointer must leave room for the SOO tag");
+
+  // Elements that fit inline. Zero for non-trivial elements (i.e. Cord), which
+  // always live in a Rep.
+  static constexpr int kSooCapacityElements =
+      std::is_trivial<Element>::value &&
+              alignof(Element) <= alignof(uintptr_t) &&
+              sizeof(Element) <= kSooCapacityBytes
+          ? std::min(static_cast<int>(kSooCapacityBytes / sizeof(Element)),
+                     static_cast<int>(kSooSizeMask))
+          : 0;
+
   RepeatedField(Arena* arena, const RepeatedField& rhs);
 
+  bool is_soo() const { return (arena_or_elements_ & kNotSooBit) == 0; }
+  int size(bool is_soo) const {
+    return is_soo ? static_cast<int>(arena_or_elements_ & kSooSizeMask)
+                  : long_rep_.size;
+  }
+  int Capacity(bool is_soo) const {
+    return is_soo ? kSooCapacityElements : long_rep_.capacity;
+  }
+  void set_size(bool is_soo, int new_size) {
+    if (is_soo) {
+      ABSL_DCHECK_LE(new_size, kSooCapacityElements);
+      arena_or_elements_ = (arena_or_elements_ & ~kSooSizeMask) |
+                           static_cast<uintptr_t>(new_size);
+    } else {
+      long_rep_.size = new_size;
+    }
+  }
+
   // Gets the Arena on which this RepeatedField stores its elements.
   inline Arena* GetOwningArena() const {
-    return (total_size_ == 0) ? static_cast<Arena*>(arena_or_elements_)
-                              : rep()->arena;
+    return is_soo() ? reinterpret_cast<Arena*>(arena_or_elements_ &
+                                               ~kSooTagMask)
+                    : rep()->arena;
   }
 
 
@@ -1556,66 +1598,76 @@ class RepeatedField final
   // Reserves space to expand the field to at least the given size.
   // If the array is grown, it will always be at least doubled in size.
   // If `annotate_size` is true (the default), then this function will annotate
-  // the old container from `current_size` to `total_size_` (unpoison memory)
+  // the old container from `current_size` to `Capacity()` (unpoison memory)
   // directly before it is being released, and annotate the new container from
-  // `total_size_` to `current_size` (poison unused memory).
+  // `Capacity()` to `current_size` (poison unused memory).
+  // The field is never in SOO mode afterwards.
   void Grow(int current_size, int new_size);
   void GrowNoAnnotate(int current_size, int new_size);
 
   // Annotates a change in size of this instance. This function should be called
-  // with (total_size, current_size) after new memory has been allocated and
-  // filled from previous memory), and called with (current_size, total_size)
-  // right before (previously annotated) memory is released.
+  // with (capacity, current_size) after new memory has been allocated and
+  // filled from previous memory), and called with (current_size, capacity)
+  // right before (previously annotated) memory is released. Inline elements
+  // are not annotated.
   void AnnotateSize(int old_size, int new_size) const {
-    if (old_size != new_size) {
+    if (old_size != new_size && !is_soo()) {
       ABSL_ANNOTATE_CONTIGUOUS_CONTAINER(
-          unsafe_elements(), unsafe_elements() + total_size_,
-          unsafe_elements() + old_size, unsafe_elements() + new_size);
+          unsafe_elements(false), unsafe_elements(false) + Capacity(false),
+          unsafe_elements(false) + old_size, unsafe_elements(false) + new_size);
       if (new_size < old_size) {
         ABSL_ANNOTATE_MEMORY_IS_UNINITIALIZED(
-            unsafe_elements() + new_size,
+            unsafe_elements(false) + new_size,
             (old_size - new_size) * sizeof(Element));
       }
     }
   }
 
-  // Replaces current_size_ with new_size and returns the previous value of
-  // current_size_. This function is intended to be the only place where
-  // current_size_ is modified, with the exception of `AddInputIterator()`
-  // where the size of added items is not known in advance.
-  inline int ExchangeCurrentSize(int new_size) {
-    const int prev_size = current_size_;
+  // Replaces the size with new_size and returns the previous size. This
+  // function is intended to be the only place where the size is modified, with
+  // the exception of `AddInputIterator()` where the size of added items is not
+  // known in advance.
+  inline int ExchangeCurrentSize(bool is_soo, int new_size) {
+    const int prev_size = size(is_soo);
     AnnotateSize(prev_size, new_size);
-    current_size_ = new_size;
+    set_size(is_soo, new_size);
     return prev_size;
   }
+  inline int ExchangeCurrentSize(int new_size) {
+    return ExchangeCurrentSize(is_soo(), new_size);
+  }
 
   // Returns a pointer to elements array.
-  // pre-condition: the array must have been allocated.
-  Element* elements() const {
-    ABSL_DCHECK_GT(total_size_, 0);
+  // pre-condition: the array must have room for elements.
+  Element* elements(bool is_soo) const {
+    ABSL_DCHECK_GT(Capacity(is_soo), 0);
     // Because of above pre-condition this cast is safe.
-    return unsafe_elements();
+    return unsafe_elements(is_soo);
   }
+  Element* elements() const { return elements(is_soo()); }
 
   // Returns a pointer to elements array if it exists; otherwise either null or
   // an invalid pointer is returned. This only happens for empty repeated
   // fields, where you can't dereference this pointer anyway (it's empty).
-  Element* unsafe_elements() const {
-    return static_cast<Element*>(arena_or_elements_);
+  Element* unsafe_elements(bool is_soo) const {
+    return is_soo ? reinterpret_cast<Element*>(
+                        const_cast<char*>(soo_elements_))
+                  : reinterpret_cast<Element*>(arena_or_elements_ -
+                                               kNotSooBit);
   }
+  Element* unsafe_elements() const { return unsafe_elements(is_soo()); }
 
   // Returns a pointer to the Rep struct.
-  // pre-condition: the Rep must have been allocated, ie elements() is safe.
+  // pre-condition: the Rep must have been allocated, ie !is_soo().
   Rep* rep() const {
-    return reinterpret_cast<Rep*>(reinterpret_cast<char*>(elements()) -
-                                  kRepHeaderSize);
+    return reinterpret_cast<Rep*>(
+        reinterpret_cast<char*>(unsafe_elements(false)) - kRepHeaderSize);
   }
 
   // Internal helper to delete all elements and deallocate the storage.
   template <bool in_destructor = false>
   void InternalDeallocate() {
-    const size_t bytes = total_size_ * sizeof(Element) + kRepHeaderSize;
+    const size_t bytes = Capacity(false) * sizeof(Element) + kRepHeaderSize;
     if (rep()->arena == nullptr) {
       internal::SizedDelete(rep(), bytes);
     } else if (!in_destructor) {
@@ -1635,44 +1687,56 @@ class RepeatedField final
   // empty (common case), and add only an 8-byte header to the elements array
   // when non-empty. We make sure to place the size fields directly in the
   // RepeatedField class to avoid costly cache misses due to the indirection.
-  int current_size_;
-  int total_size_;
-  // If total_size_ == 0 this points to an Arena otherwise it points to the
-  // elements member of a Rep struct. Using this invariant allows the storage of
-  // the arena pointer without an extra allocation in the constructor.
-  void* arena_or_elements_;
+  // Fields with a few elements need no allocation at all: see is_soo().
+  struct LongRep {
+    int size;
+    int capacity;
+  };
+  union {
+    LongRep long_rep_;
+    alignas(uintptr_t) char soo_elements_[kSooCapacityBytes];
+  };
+  // In SOO mode this is the Arena pointer plus the size, otherwise it points to
+  // the elements member of a Rep struct, plus kNotSooBit. Using this invariant
+  // allows the storage of the arena pointer without an extra allocation in the
+  // constructor.
+  uintptr_t arena_or_elements_;
 };
 
 // implementation ====================================================
 
 template <typename Element>
 constexpr RepeatedField<Element>::RepeatedField()
-    : current_size_(0), total_size_(0), arena_or_elements_(nullptr) {
+    : long_rep_{0, 0}, arena_or_elements_(0) {
   StaticValidityCheck();
 }
 
 template <typename Element>
 inline RepeatedField<Element>::RepeatedField(Arena* arena)
-    : current_size_(0), total_size_(0), arena_or_elements_(arena) {
+    : long_rep_{0, 0}, arena_or_elements_(reinterpret_cast<uintptr_t>(arena)) {
   StaticValidityCheck();
 }
 
 template <typename Element>
 inline RepeatedField<Element>::RepeatedField(Arena* arena,
                                              const RepeatedField& rhs)
-    : current_size_(0), total_size_(0), arena_or_elements_(arena) {
+    : long_rep_{0, 0}, arena_or_elements_(reinterpret_cast<uintptr_t>(arena)) {
   StaticValidityCheck();
-  if (auto size = rhs.current_size_) {
-    Grow(0, size);
-    ExchangeCurrentSize(size);
-    UninitializedCopyN(rhs.elements(), size, unsafe_elements());
+  if (auto size = rhs.size()) {
+    bool is_soo = true;
+    if (size > kSooCapacityElements) {
+      Grow(0, size);
+      is_soo = false;
+    }
+    ExchangeCurrentSize(is_soo, size);
+    UninitializedCopyN(rhs.elements(), size, unsafe_elements(is_soo));
   }
 }
 
 template <typename Element>
 template <typename Iter, typename>
 RepeatedField<Element>::RepeatedField(Iter begin, Iter end)
-    : current_size_(0), total_size_(0), arena_or_elements_(nullptr) {
+    : long_rep_{0, 0}, arena_or_elements_(0) {
   StaticValidityCheck();
   Add(begin, end);
 }
@@ -1686,8 +1750,8 @@ RepeatedField<Element>::~RepeatedField() {
   auto arena = GetArena();
   if (arena) (void)arena->SpaceAllocated();
 #endif
-  if (total_size_ > 0) {
-    Destroy(unsafe_elements(), unsafe_elements() + current_size_);
+  if (!is_soo()) {
+    Destroy(unsafe_elements(false), unsafe_elements(false) + size(false));
     InternalDeallocate<true>();
   }
 }
@@ -1737,42 +1801,49 @@ inline RepeatedField<Element>& RepeatedField<Element>::operator=(
 
 template <typename Element>
 inline bool RepeatedField<Element>::empty() const {
-  return current_size_ == 0;
+  return size() == 0;
 }
 
 template <typename Element>
 inline int RepeatedField<Element>::size() const {
-  return current_size_;
+  return size(is_soo());
 }
 
 template <typename Element>
 inline int RepeatedField<Element>::Capacity() const {
-  return total_size_;
+  return Capacity(is_soo());
 }
 
 template <typename Element>
 inline void RepeatedField<Element>::AddAlreadyReserved(Element value) {
-  ABSL_DCHECK_LT(current_size_, total_size_);
-  void* p = elements() + ExchangeCurrentSize(current_size_ + 1);
+  const bool is_soo = this->is_soo();
+  const int old_size = size(is_soo);
+  ABSL_DCHECK_LT(old_size, Capacity(is_soo));
+  void* p = elements(is_soo) + ExchangeCurrentSize(is_soo, old_size + 1);
   ::new (p) Element(std::move(value));
 }
 
 template <typename Element>
 inline Element* RepeatedField<Element>::AddAlreadyReserved()
     ABSL_ATTRIBUTE_LIFETIME_BOUND {
-  ABSL_DCHECK_LT(current_size_, total_size_);
+  const bool is_soo = this->is_soo();
+  const int old_size = size(is_soo);
+  ABSL_DCHECK_LT(old_size, Capacity(is_soo));
   // new (p) <TrivialType> compiles into nothing: this is intentional as this
   // function is documented to return uninitialized data for trivial types.
-  void* p = elements() + ExchangeCurrentSize(current_size_ + 1);
+  void* p = elements(is_soo) + ExchangeCurrentSize(is_soo, old_size + 1);
   return ::new (p) Element;
 }
 
 template <typename Element>
 inline Element* RepeatedField<Element>::AddNAlreadyReserved(int n)
     ABSL_ATTRIBUTE_LIFETIME_BOUND {
-  ABSL_DCHECK_GE(total_size_ - current_size_, n)
-      << total_size_ << ", " << current_size_;
-  Element* p = unsafe_elements() + ExchangeCurrentSize(current_size_ + n);
+  const bool is_soo = this->is_soo();
+  const int old_size = size(is_soo);
+  ABSL_DCHECK_GE(Capacity(is_soo) - old_size, n)
+      << Capacity(is_soo) << ", " << old_size;
+  Element* p =
+      unsafe_elements(is_soo) + ExchangeCurrentSize(is_soo, old_size + n);
   for (Element *begin = p, *end = p + n; begin != end; ++begin) {
     new (static_cast<void*>(begin)) Element;
   }
@@ -1782,12 +1853,14 @@ inline Element* RepeatedField<Element>::AddNAlreadyReserved(int n)
 template <typename Element>
 inline void RepeatedField<Element>::Resize(int new_size, const Element& value) {
   ABSL_DCHECK_GE(new_size, 0);
-  if (new_size > current_size_) {
-    if (new_size > total_size_) Grow(current_size_, new_size);
+  const int old_size = size();
+  if (new_size > old_size) {
+    if (new_size > Capacity()) Grow(old_size, new_size);
     Element* first = elements() + ExchangeCurrentSize(new_size);
-    std::uninitialized_fill(first, elements() + current_size_, value);
-  } else if (new_size < current_size_) {
-    Destroy(unsafe_elements() + new_size, unsafe_elements() + current_size_);
+    std::uninitialized_fill(first, elements() + new_size, value);
+  } else if (new_size < old_size) {
+    Element* elem = unsafe_elements();
+    Destroy(elem + new_size, elem + old_size);
     ExchangeCurrentSize(new_size);
   }
 }
@@ -1796,7 +1869,7 @@ template <typename Element>
 inline const Element& RepeatedField<Element>::Get(int index) const
     ABSL_ATTRIBUTE_LIFETIME_BOUND {
   ABSL_DCHECK_GE(index, 0);
-  ABSL_DCHECK_LT(index, current_size_);
+  ABSL_DCHECK_LT(index, size());
   return elements()[index];
 }
 
@@ -1804,7 +1877,7 @@ template <typename Element>
 inline const Element& RepeatedField<Element>::at(int index) const
     ABSL_ATTRIBUTE_LIFETIME_BOUND {
   ABSL_CHECK_GE(index, 0);
-  ABSL_CHECK_LT(index, current_size_);
+  ABSL_CHECK_LT(index, size());
   return elements()[index];
 }
 
@@ -1812,7 +1885,7 @@ template <typename Element>
 inline Element& RepeatedField<Element>::at(int index)
     ABSL_ATTRIBUTE_LIFETIME_BOUND {
   ABSL_CHECK_GE(index, 0);
-  ABSL_CHECK_LT(index, current_size_);
+  ABSL_CHECK_LT(index, size());
   return elements()[index];
 }
 
@@ -1820,85 +1893,99 @@ template <typename Element>
 inline Element* RepeatedField<Element>::Mutable(int index)
     ABSL_ATTRIBUTE_LIFETIME_BOUND {
   ABSL_DCHECK_GE(index, 0);
-  ABSL_DCHECK_LT(index, current_size_);
+  ABSL_DCHECK_LT(index, size());
   return &elements()[index];
 }
 
 template <typename Element>
 inline void RepeatedField<Element>::Set(int index, const Element& value) {
   ABSL_DCHECK_GE(index, 0);
-  ABSL_DCHECK_LT(index, current_size_);
+  ABSL_DCHECK_LT(index, size());
   elements()[index] = value;
 }
 
 template <typename Element>
 inline void RepeatedField<Element>::Add(Element value) {
-  int total_size = total_size_;
-  Element* elem = unsafe_elements();
-  if (ABSL_PREDICT_FALSE(current_size_ == total_size)) {
-    Grow(current_size_, current_size_ + 1);
-    total_size = total_size_;
-    elem = unsafe_elements();
+  bool is_soo = this->is_soo();
+  const int old_size = size(is_soo);
+  int capacity = Capacity(is_soo);
+  Element* elem = unsafe_elements(is_soo);
+  if (ABSL_PREDICT_FALSE(old_size == capacity)) {
+    Grow(old_size, old_size + 1);
+    is_soo = false;
+    capacity = Capacity(false);
+    elem = unsafe_elements(false);
   }
-  int new_size = current_size_ + 1;
-  void* p = elem + ExchangeCurrentSize(new_size);
+  int new_size = old_size + 1;
+  void* p = elem + ExchangeCurrentSize(is_soo, new_size);
   ::new (p) Element(std::move(value));
 
   // The below helps the compiler optimize dense loops.
-  ABSL_ASSUME(new_size == current_size_);
-  ABSL_ASSUME(elem == arena_or_elements_);
-  ABSL_ASSUME(total_size == total_size_);
+  ABSL_ASSUME(is_soo == this->is_soo());
+  ABSL_ASSUME(new_size == size(is_soo));
+  ABSL_ASSUME(elem == unsafe_elements(is_soo));
+  ABSL_ASSUME(capacity == Capacity(is_soo));
 }
 
 template <typename Element>
 inline Element* RepeatedField<Element>::Add() ABSL_ATTRIBUTE_LIFETIME_BOUND {
-  if (ABSL_PREDICT_FALSE(current_size_ == total_size_)) {
-    Grow(current_size_, current_size_ + 1);
+  bool is_soo = this->is_soo();
+  const int old_size = size(is_soo);
+  if (ABSL_PREDICT_FALSE(old_size == Capacity(is_soo))) {
+    Grow(old_size, old_size + 1);
+    is_soo = false;
   }
-  void* p = unsafe_elements() + ExchangeCurrentSize(current_size_ + 1);
+  void* p = unsafe_elements(is_soo) + ExchangeCurrentSize(is_soo, old_size + 1);
   return ::new (p) Element;
 }
 
 template <typename Element>
 template <typename Iter>
 inline void RepeatedField<Element>::AddForwardIterator(Iter begin, Iter end) {
-  int total_size = total_size_;
-  Element* elem = unsafe_elements();
-  int new_size = current_size_ + static_cast<int>(std::distance(begin, end));
-  if (ABSL_PREDICT_FALSE(new_size > total_size)) {
-    Grow(current_size_, new_size);
-    elem = unsafe_elements();
-    total_size = total_size_;
+  bool is_soo = this->is_soo();
+  const int old_size = size(is_soo);
+  int capacity = Capacity(is_soo);
+  Element* elem = unsafe_elements(is_soo);
+  int new_size = old_size + static_cast<int>(std::distance(begin, end));
+  if (ABSL_PREDICT_FALSE(new_size > capacity)) {
+    Grow(old_size, new_size);
+    is_soo = false;
+    elem = unsafe_elements(false);
+    capacity = Capacity(false);
   }
-  UninitializedCopy(begin, end, elem + ExchangeCurrentSize(new_size));
+  UninitializedCopy(begin, end, elem + ExchangeCurrentSize(is_soo, new_size));
 
   // The below helps the compiler optimize dense loops.
-  ABSL_ASSUME(new_size == current_size_);
-  ABSL_ASSUME(elem == arena_or_elements_);
-  ABSL_ASSUME(total_size == total_size_);
+  ABSL_ASSUME(is_soo == this->is_soo());
+  ABSL_ASSUME(new_size == size(is_soo));
+  ABSL_ASSUME(elem == unsafe_elements(is_soo));
+  ABSL_ASSUME(capacity == Capacity(is_soo));
 }
 
 template <typename Element>
 template <typename Iter>
 inline void RepeatedField<Element>::AddInputIterator(Iter begin, Iter end) {
-  Element* first = unsafe_elements() + current_size_;
-  Element* last = unsafe_elements() + total_size_;
-  AnnotateSize(current_size_, total_size_);
+  bool is_soo = this->is_soo();
+  Element* first = unsafe_elements(is_soo) + size(is_soo);
+  Element* last = unsafe_elements(is_soo) + Capacity(is_soo);
+  AnnotateSize(size(is_soo), Capacity(is_soo));
 
   while (begin != end) {
     if (ABSL_PREDICT_FALSE(first == last)) {
-      int current_size = first - unsafe_elements();
+      int current_size = first - unsafe_elements(is_soo);
       GrowNoAnnotate(current_size, current_size + 1);
-      first = unsafe_elements() + current_size;
-      last = unsafe_elements() + total_size_;
+      is_soo = false;
+      first = unsafe_elements(false) + current_size;
+      last = unsafe_elements(false) + Capacity(false);
     }
     ::new (static_cast<void*>(first)) Element(*begin);
     ++begin;
     ++first;
   }
 
-  current_size_ = first - unsafe_elements();
-  AnnotateSize(total_size_, current_size_);
+  const int new_size = first - unsafe_elements(is_soo);
+  set_size(is_soo, new_size);
+  AnnotateSize(Capacity(is_soo), new_size);
 }
 
 template <typename Element>
@@ -1915,9 +2002,11 @@ inline void RepeatedField<Element>::Add(Iter begin, Iter end) {
 
 template <typename Element>
 inline void RepeatedField<Element>::RemoveLast() {
-  ABSL_DCHECK_GT(current_size_, 0);
-  elements()[current_size_ - 1].~Element();
-  ExchangeCurrentSize(current_size_ - 1);
+  const bool is_soo = this->is_soo();
+  const int old_size = size(is_soo);
+  ABSL_DCHECK_GT(old_size, 0);
+  elements(is_soo)[old_size - 1].~Element();
+  ExchangeCurrentSize(is_soo, old_size - 1);
 }
 
 template <typename Element>
@@ -1925,7 +2014,7 @@ void RepeatedField<Element>::ExtractSubrange(int start, int num,
                                              Element* elements) {
   ABSL_DCHECK_GE(start, 0);
   ABSL_DCHECK_GE(num, 0);
-  ABSL_DCHECK_LE(start + num, this->current_size_);
+  ABSL_DCHECK_LE(start + num, this->size());
 
   // Save the values of the removed elements if requested.
   if (elements != nullptr) {
@@ -1934,25 +2023,29 @@ void RepeatedField<Element>::ExtractSubrange(int start, int num,
 
   // Slide remaining elements down to fill the gap.
   if (num > 0) {
-    for (int i = start + num; i < this->current_size_; ++i)
+    const int old_size = this->size();
+    for (int i = start + num; i < old_size; ++i)
       this->Set(i - num, this->Get(i));
-    this->Truncate(this->current_size_ - num);
+    this->Truncate(old_size - num);
   }
 }
 
 template <typename Element>
 inline void RepeatedField<Element>::Clear() {
-  Destroy(unsafe_elements(), unsafe_elements() + current_size_);
-  ExchangeCurrentSize(0);
+  const bool is_soo = this->is_soo();
+  Element* elem = unsafe_elements(is_soo);
+  Destroy(elem, elem + size(is_soo));
+  ExchangeCurrentSize(is_soo, 0);
 }
 
 template <typename Element>
 inline void RepeatedField<Element>::MergeFrom(const RepeatedField& other) {
   ABSL_DCHECK_NE(&other, this);
-  if (auto size = other.current_size_) {
-    Reserve(current_size_ + size);
-    Element* dst = elements() + ExchangeCurrentSize(current_size_ + size);
-    UninitializedCopyN(other.elements(), size, dst);
+  if (auto other_size = other.size()) {
+    const int old_size = size();
+    Reserve(old_size + other_size);
+    Element* dst = elements() + ExchangeCurrentSize(old_size + other_size);
+    UninitializedCopyN(other.elements(), other_size, dst);
   }
 }
 
@@ -2006,7 +2099,7 @@ inline void RepeatedField<Element>::InternalSwap(
   // Swap all fields at once.
   static_assert(std::is_standard_layout<RepeatedField<Element>>::value,
                 "offsetof() requires standard layout before c++17");
-  static constexpr size_t kOffset = offsetof(RepeatedField, current_size_);
+  static constexpr size_t kOffset = offsetof(RepeatedField, long_rep_);
   internal::memswap<offsetof(RepeatedField, arena_or_elements_) +
                     sizeof(this->arena_or_elements_) - kOffset>(
       reinterpret_cast<char*>(this) + kOffset,
@@ -2061,22 +2154,22 @@ RepeatedField<Element>::cbegin() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
 template <typename Element>
 inline typename RepeatedField<Element>::iterator RepeatedField<Element>::end()
     ABSL_ATTRIBUTE_LIFETIME_BOUND {
-  return iterator(unsafe_elements() + current_size_);
+  return iterator(unsafe_elements() + size());
 }
 template <typename Element>
 inline typename RepeatedField<Element>::const_iterator
 RepeatedField<Element>::end() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
-  return const_iterator(unsafe_elements() + current_size_);
+  return const_iterator(unsafe_elements() + size());
 }
 template <typename Element>
 inline typename RepeatedField<Element>::const_iterator
 RepeatedField<Element>::cend() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
-  return const_iterator(unsafe_elements() + current_size_);
+  return const_iterator(unsafe_elements() + size());
 }
 
 template <typename Element>
 inline size_t RepeatedField<Element>::SpaceUsedExcludingSelfLong() const {
-  return total_size_ > 0 ? (total_size_ * sizeof(Element) + kRepHeaderSize) : 0;
+  return is_soo() ? 0 : Capacity(false) * sizeof(Element) + kRepHeaderSize;
 }
 
 namespace internal {
@@ -2110,8 +2203,8 @@ inline int CalculateReserveSize(int total_size, int new_size) {
 
 template <typename Element>
 void RepeatedField<Element>::Reserve(int new_size) {
-  if (ABSL_PREDICT_FALSE(new_size > total_size_)) {
-    Grow(current_size_, new_size);
+  if (ABSL_PREDICT_FALSE(new_size > Capacity())) {
+    Grow(size(), new_size);
   }
 }
 
@@ -2120,12 +2213,14 @@ void RepeatedField<Element>::Reserve(int new_size) {
 template <typename Element>
 PROTOBUF_NOINLINE void RepeatedField<Element>::GrowNoAnnotate(int current_size,
                                                               int new_size) {
-  ABSL_DCHECK_GT(new_size, total_size_);
+  const bool was_soo = is_soo();
+  const int old_capacity = Capacity(was_soo);
+  ABSL_DCHECK_GT(new_size, old_capacity);
   Rep* new_rep;
   Arena* arena = GetArena();
 
   new_size = internal::CalculateReserveSize<Element, kRepHeaderSize>(
-      total_size_, new_size);
+      old_capacity, new_size);
 
   ABSL_DCHECK_LE(
       static_cast<size_t>(new_size),
@@ -2147,26 +2242,32 @@ PROTOBUF_NOINLINE void RepeatedField<Element>::GrowNoAnnotate(int current_size,
     new_rep = reinterpret_cast<Rep*>(Arena::CreateArray<char>(arena, bytes));
   }
   new_rep->arena = arena;
-
-  if (total_size_ > 0) {
-    if (current_size > 0) {
-      Element* pnew = new_rep->elements();
-      Element* pold = elements();
-      // TODO: add absl::is_trivially_relocatable<Element>
-      if (std::is_trivial<Element>::value) {
-        memcpy(static_cast<void*>(pnew), pold, current_size * sizeof(Element));
-      } else {
-        for (Element* end = pnew + current_size; pnew != end; ++pnew, ++pold) {
-          ::new (static_cast<void*>(pnew)) Element(std::move(*pold));
-          pold->~Element();
-        }
+  ABSL_DCHECK_EQ(reinterpret_cast<uintptr_t>(new_rep->elements()) & kSooTagMask,
+                 0u);
+
+  if (current_size > 0) {
+    Element* pnew = new_rep->elements();
+    Element* pold = unsafe_elements(was_soo);
+    // TODO: add absl::is_trivially_relocatable<Element>
+    if (std::is_trivial<Element>::value) {
+      memcpy(static_cast<void*>(pnew), pold, current_size * sizeof(Element));
+    } else {
+      for (Element* end = pnew + current_size; pnew != end; ++pnew, ++pold) {
+        ::new (static_cast<void*>(pnew)) Element(std::move(*pold));
+        pold->~Element();
       }
     }
+  }
+  if (was_soo) {
+    // The inline elements have moved out, so the size can take their place.
+    long_rep_.size = size(true);
+  } else {
     InternalDeallocate();
   }
 
-  total_size_ = new_size;
-  arena_or_elements_ = new_rep->elements();
+  long_rep_.capacity = new_size;
+  arena_or_elements_ =
+      reinterpret_cast<uintptr_t>(new_rep->elements()) | kNotSooBit;
 }
 
 // Ideally we would be able to use:
@@ -2177,17 +2278,20 @@ PROTOBUF_NOINLINE void RepeatedField<Element>::GrowNoAnnotate(int current_size,
 template <typename Element>
 PROTOBUF_NOINLINE void RepeatedField<Element>::Grow(int current_size,
                                                     int new_size) {
-  AnnotateSize(current_size, total_size_);
+  AnnotateSize(current_size, Capacity());
   GrowNoAnnotate(current_size, new_size);
-  AnnotateSize(total_size_, current_size);
+  AnnotateSize(Capacity(), current_size);
 }
 
 template <typename Element>
 inline void RepeatedField<Element>::Truncate(int new_size) {
-  ABSL_DCHECK_LE(new_size, current_size_);
-  if (new_size < current_size_) {
-    Destroy(unsafe_elements() + new_size, unsafe_elements() + current_size_);
-    ExchangeCurrentSize(new_size);
+  const bool is_soo = this->is_soo();
+  const int old_size = size(is_soo);
+  ABSL_DCHECK_LE(new_size, old_size);
+  if (new_size < old_size) {
+    Element* elem = unsafe_elements(is_soo);
+    Destroy(elem + new_size, elem + old_size);
+    ExchangeCurrentSize(is_soo, new_size);
   }
 }
 
@@ -1306,6 +1306,10 @@ void* RepeatedPtrFieldBase::AddOutOfLineHelper(void* obj) {
 }
 
 void* RepeatedPtrFieldBase::AddOutOfLineHelper(ElementFactory factory) {
+  if (PROTOBUF_PREDICT_FALSE(UseElementChunks()) &&
+      current_size_ == allocated_size()) {
+    return AddFromChunk(factory);
+  }
   if (tagged_rep_or_elem_ == nullptr) {
     ExchangeCurrentSize(1);
     tagged_rep_or_elem_ = factory(GetArena());
@@ -1345,6 +1345,8 @@ class PROTOBUF_EXPORT RepeatedPtrFieldBase {
   using Value = typename Handler::Type;
 
   static constexpr int kSSOCapacity = 1;
+  static constexpr int kMinElementChunk = 4;
+  static constexpr int kMaxElementChunk = 64;
 
   using ElementFactory = void* (*)(Arena*);
 
@@ -1414,6 +1416,11 @@ class PROTOBUF_EXPORT RepeatedPtrFieldBase {
       return cast<TypeHandler>(
           element_at(ExchangeCurrentSize(current_size_ + 1)));
     }
+    if (PROTOBUF_PREDICT_FALSE(UseElementChunks())) {
+      return cast<TypeHandler>(AddFromChunk([prototype](Arena* arena) {
+        return TypeHandler::NewFromPrototype(prototype, arena);
+      }));
+    }
     auto* result = TypeHandler::NewFromPrototype(prototype, arena_);
     return cast<TypeHandler>(AddOutOfLineHelper(result));
   }
@@ -2009,6 +2016,31 @@ class PROTOBUF_EXPORT RepeatedPtrFieldBase {
   void* AddOutOfLineHelper(void* obj);
   void* AddOutOfLineHelper(ElementFactory factory);
 
+  // Whether new elements are created a chunk at a time, which the arena
+  // requests with ArenaOptions::contiguous_repeated_elements.
+  bool UseElementChunks() const {
+    return arena_ != nullptr && arena_->impl_.contiguous_repeated_elements();
+  }
+
+  // Adds a new element when there are no cleared elements to reuse. Creates a
+  // chunk of elements back to back with `new_element` and keeps all but the
+  // first as cleared elements, for later calls to Add() to reuse. The chunk
+  // grows with the field, so at most half of the elements are spare.
+  template <typename Factory>
+  PROTOBUF_NOINLINE void* AddFromChunk(Factory new_element) {
+    ABSL_DCHECK_EQ(current_size_, allocated_size());
+    const int n = std::min(std::max(current_size_, kMinElementChunk),
+                           kMaxElementChunk);
+    // Always leaves the SSO mode, since the chunk has several elements.
+    void** chunk = InternalReserve(current_size_ + n);
+    for (int i = 0; i < n; ++i) {
+      chunk[i] = new_element(arena_);
+    }
+    rep()->allocated_size += n;
+    ExchangeCurrentSize(current_size_ + 1);
+    return chunk[0];
+  }
+
   // A few notes on internal representation:
   //
   // We use an indirected approach, with struct Rep, to keep
@@ -19,11 +19,14 @@
 #include <climits>
 #include <cmath>
 #include <limits>
+#include <memory>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
 #include <CppAbseil/absl_container_btree_set.hpp>
+#include <CppAbseil/absl_container_flat_hash_map.hpp>
 #include <CppAbseil/absl_strings_ascii.hpp>
 #include <CppAbseil/absl_strings_cord.hpp>
 #include <CppAbseil/absl_strings_escaping.hpp>
@@ -1664,6 +1667,44 @@ class TextFormat::Parser::ParserImpl {
   }
 
 
+  // Looks up the field that `field_name` refers to in text format, i.e. by
+  // field name, or by type name for groups. Hits are memoized in a small table
+  // per descriptor, which is much cheaper to probe than the pool-wide symbol
+  // table behind Descriptor::FindFieldByName().
+  const FieldDescriptor* FindFieldByTextName(const Descriptor* descriptor,
+                                             const std::string& field_name) {
+    if (descriptor != last_field_names_descriptor_) {
+      last_field_names_descriptor_ = descriptor;
+      last_field_names_ = &field_names_[descriptor];
+    }
+    auto it = last_field_names_->find(field_name);
+    if (it != last_field_names_->end()) return it->second;
+
+    const FieldDescriptor* field = descriptor->FindFieldByName(field_name);
+    // Group names are expected to be capitalized as they appear in the
+    // .proto file, which actually matches their type names, not their
+    // field names.
+    if (field == nullptr) {
+      std::string lower_field_name = field_name;
+      absl::AsciiStrToLower(&lower_field_name);
+      field = descriptor->FindFieldByName(lower_field_name);
+      // If the case-insensitive match worked but the field is NOT a group,
+      if (field != nullptr && field->type() != FieldDescriptor::TYPE_GROUP) {
+        field = nullptr;
+      }
+    }
+    // Again, special-case group names as described above.
+    if (field != nullptr && field->type() == FieldDescriptor::TYPE_GROUP &&
+        field->message_type()->name() != field_name) {
+      field = nullptr;
+    }
+
+    if (field != nullptr) {
+      last_field_names_->emplace(field_name, field);
+    }
+    return field;
+  }
+
   // Consumes the current field (as returned by the tokenizer) on the
   // passed in message.
   bool ConsumeField(Message* message) {
@@ -1758,25 +1799,7 @@ class TextFormat::Parser::ParserImpl {
           field = descriptor->FindFieldByNumber(field_number);
         }
       } else {
-        field = descriptor->FindFieldByName(field_name);
-        // Group names are expected to be capitalized as they appear in the
-        // .proto file, which actually matches their type names, not their
-        // field names.
-        if (field == nullptr) {
-          std::string lower_field_name = field_name;
-          absl::AsciiStrToLower(&lower_field_name);
-          field = descriptor->FindFieldByName(lower_field_name);
-          // If the case-insensitive match worked but the field is NOT a group,
-          if (field != nullptr &&
-              field->type() != FieldDescriptor::TYPE_GROUP) {
-            field = nullptr;
-          }
-        }
-        // Again, special-case group names as described above.
-        if (field != nullptr && field->type() == FieldDescriptor::TYPE_GROUP &&
-            field->message_type()->name() != field_name) {
-          field = nullptr;
-        }
+        field = FindFieldByTextName(descriptor, field_name);
 
         if (field == nullptr && allow_case_insensitive_field_) {
           std::string lower_field_name = field_name;
@@ -2613,6 +2636,16 @@ class TextFormat::Parser::ParserImpl {
   bool had_errors_;
   bool error_on_no_op_fields_;
 
+  // Per-descriptor memo for FindFieldByTextName(). The table of the most
+  // recently used descriptor is cached, since consecutive fields usually
+  // belong to the same message; the outer map only grows when that cache is
+  // refreshed, so the cached pointer never dangles.
+  absl::flat_hash_map<const Descriptor*,
+                      absl::flat_hash_map<std::string, const FieldDescriptor*>>
+      field_names_;
+  const Descriptor* last_field_names_descriptor_ = nullptr;
+  absl::flat_hash_map<std::string, const FieldDescriptor*>* last_field_names_ =
+      nullptr;
 };
 
 // ===========================================================================
@@ -2819,6 +2852,50 @@ class TextFormat::Printer::DebugStringFieldValuePrinter
   }
 };
 
+namespace {
+// Prints `src` escaped exactly as absl::CEscape() (or absl::Utf8SafeCEscape()
+// if `utf8_safe`) would, without building the escaped copy: runs that need no
+// escaping are handed to the generator in place.
+void PrintCEscaped(absl::string_view src, bool utf8_safe,
+                   TextFormat::BaseTextGenerator* generator) {
+  size_t run_start = 0;
+  for (size_t i = 0; i < src.size(); ++i) {
+    unsigned char c = static_cast<unsigned char>(src[i]);
+    char escaped[4] = {'\\'};
+    size_t escaped_size = 2;
+    switch (c) {
+      case '\n':
+        escaped[1] = 'n';
+        break;
+      case '\r':
+        escaped[1] = 'r';
+        break;
+      case '\t':
+        escaped[1] = 't';
+        break;
+      case '\"':
+      case '\'':
+      case '\\':
+        escaped[1] = static_cast<char>(c);
+        break;
+      default:
+        if ((utf8_safe && c >= 0x80) || absl::ascii_isprint(c)) continue;
+        escaped[1] = static_cast<char>('0' + (c >> 6));
+        escaped[2] = static_cast<char>('0' + ((c >> 3) & 7));
+        escaped[3] = static_cast<char>('0' + (c & 7));
+        escaped_size = 4;
+        break;
+    }
+    if (i > run_start) generator->Print(src.data() + run_start, i - run_start);
+    generator->Print(escaped, escaped_size);
+    run_start = i + 1;
+  }
+  if (src.size() > run_start) {
+    generator->Print(src.data() + run_start, src.size() - run_start);
+  }
+}
+}  // namespace
+
 // ===========================================================================
 //  An internal field value printer that escape UTF8 strings.
 class TextFormat::Printer::FastFieldValuePrinterUtf8Escaping
@@ -2827,7 +2904,7 @@ class TextFormat::Printer::FastFieldValuePrinterUtf8Escaping
   void PrintString(const std::string& val,
                    TextFormat::BaseTextGenerator* generator) const override {
     generator->PrintLiteral("\"");
-    generator->PrintString(absl::Utf8SafeCEscape(val));
+    PrintCEscaped(val, /*utf8_safe=*/true, generator);
     generator->PrintLiteral("\"");
   }
   void PrintBytes(const std::string& val,
@@ -3095,29 +3172,41 @@ void TextFormat::FastFieldValuePrinter::PrintBool(
     generator->PrintLiteral("false");
   }
 }
+// The scalar printers below format into stack buffers (AlphaNum keeps its
+// digits inline) so that printing a value never allocates.
 void TextFormat::FastFieldValuePrinter::PrintInt32(
     int32_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  generator->PrintString(absl::AlphaNum(val).Piece());
 }
 void TextFormat::FastFieldValuePrinter::PrintUInt32(
     uint32_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  generator->PrintString(absl::AlphaNum(val).Piece());
 }
 void TextFormat::FastFieldValuePrinter::PrintInt64(
     int64_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  generator->PrintString(absl::AlphaNum(val).Piece());
 }
 void TextFormat::FastFieldValuePrinter::PrintUInt64(
     uint64_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  generator->PrintString(absl::AlphaNum(val).Piece());
 }
 void TextFormat::FastFieldValuePrinter::PrintFloat(
     float val, BaseTextGenerator* generator) const {
-  generator->PrintString(!std::isnan(val) ? io::SimpleFtoa(val) : "nan");
+  if (std::isnan(val)) {
+    generator->PrintLiteral("nan");
+    return;
+  }
+  char buffer[io::kFloatToBufferSize];
+  generator->PrintString(io::FloatToBuffer(val, buffer));
 }
 void TextFormat::FastFieldValuePrinter::PrintDouble(
     double val, BaseTextGenerator* generator) const {
-  generator->PrintString(!std::isnan(val) ? io::SimpleDtoa(val) : "nan");
+  if (std::isnan(val)) {
+    generator->PrintLiteral("nan");
+    return;
+  }
+  char buffer[io::kDoubleToBufferSize];
+  generator->PrintString(io::DoubleToBuffer(val, buffer));
 }
 void TextFormat::FastFieldValuePrinter::PrintEnum(
     int32_t /*val*/, const std::string& name,
@@ -3128,7 +3217,7 @@ void TextFormat::FastFieldValuePrinter::PrintEnum(
 void TextFormat::FastFieldValuePrinter::PrintString(
     const std::string& val, BaseTextGenerator* generator) const {
   generator->PrintLiteral("\"");
-  generator->PrintString(absl::CEscape(val));
+  PrintCEscaped(val, /*utf8_safe=*/false, generator);
   generator->PrintLiteral("\"");
 }
 void TextFormat::FastFieldValuePrinter::PrintBytes(
@@ -3279,6 +3368,8 @@ TextFormat::Printer::Printer()
       print_message_fields_in_index_order_(false),
       expand_any_(false),
       truncate_string_field_longer_than_(0LL),
+      parallel_print_threads_(1),
+      parallel_print_min_elements_(0),
       finder_(nullptr) {
   SetUseUtf8StringEscaping(false);
 }
@@ -3587,122 +3678,29 @@ class MapFieldPrinterHelper {
   static bool SortMap(const Message& message, const Reflection* reflection,
                       const FieldDescriptor* field,
                       std::vector<const Message*>* sorted_map_field);
-  static void CopyKey(const MapKey& key, Message* message,
-                      const FieldDescriptor* field_desc);
-  static void CopyValue(const MapValueRef& value, Message* message,
-                        const FieldDescriptor* field_desc);
 };
 
-// Returns true if elements contained in sorted_map_field need to be released.
+// Sorts the entries of the repeated field if it is up to date. Otherwise
+// returns false, and the map is to be read with a MapEntryReader so that the
+// repeated field is not built just for printing.
 bool MapFieldPrinterHelper::SortMap(
     const Message& message, const Reflection* reflection,
     const FieldDescriptor* field,
     std::vector<const Message*>* sorted_map_field) {
-  bool need_release = false;
   const MapFieldBase& base = *reflection->GetMapData(message, field);
+  if (!base.IsRepeatedFieldValid()) return false;
 
-  if (base.IsRepeatedFieldValid()) {
-    const RepeatedPtrField<Message>& map_field =
-        reflection->GetRepeatedPtrFieldInternal<Message>(message, field);
-    for (int i = 0; i < map_field.size(); ++i) {
-      sorted_map_field->push_back(
-          const_cast<RepeatedPtrField<Message>*>(&map_field)->Mutable(i));
-    }
-  } else {
-    // TODO: For performance, instead of creating map entry message
-    // for each element, just store map keys and sort them.
-    const Descriptor* map_entry_desc = field->message_type();
-    const Message* prototype =
-        reflection->GetMessageFactory()->GetPrototype(map_entry_desc);
-    for (MapIterator iter =
-             reflection->MapBegin(const_cast<Message*>(&message), field);
-         iter != reflection->MapEnd(const_cast<Message*>(&message), field);
-         ++iter) {
-      Message* map_entry_message = prototype->New();
-      CopyKey(iter.GetKey(), map_entry_message, map_entry_desc->field(0));
-      CopyValue(iter.GetValueRef(), map_entry_message,
-                map_entry_desc->field(1));
-      sorted_map_field->push_back(map_entry_message);
-    }
-    need_release = true;
+  const RepeatedPtrField<Message>& map_field =
+      reflection->GetRepeatedPtrFieldInternal<Message>(message, field);
+  for (int i = 0; i < map_field.size(); ++i) {
+    sorted_map_field->push_back(
+        const_cast<RepeatedPtrField<Message>*>(&map_field)->Mutable(i));
   }
 
   MapEntryMessageComparator comparator(field->message_type());
   std::stable_sort(sorted_map_field->begin(), sorted_map_field->end(),
                    comparator);
-  return need_release;
-}
-
-void MapFieldPrinterHelper::CopyKey(const MapKey& key, Message* message,
-                                    const FieldDescriptor* field_desc) {
-  const Reflection* reflection = message->GetReflection();
-  switch (field_desc->cpp_type()) {
-    case FieldDescriptor::CPPTYPE_DOUBLE:
-    case FieldDescriptor::CPPTYPE_FLOAT:
-    case FieldDescriptor::CPPTYPE_ENUM:
-    case FieldDescriptor::CPPTYPE_MESSAGE:
-      ABSL_LOG(ERROR) << "Not supported.";
-      break;
-    case FieldDescriptor::CPPTYPE_STRING:
-      reflection->SetString(message, field_desc, key.GetStringValue());
-      return;
-    case FieldDescriptor::CPPTYPE_INT64:
-      reflection->SetInt64(message, field_desc, key.GetInt64Value());
-      return;
-    case FieldDescriptor::CPPTYPE_INT32:
-      reflection->SetInt32(message, field_desc, key.GetInt32Value());
-      return;
-    case FieldDescriptor::CPPTYPE_UINT64:
-      reflection->SetUInt64(message, field_desc, key.GetUInt64Value());
-      return;
-    case FieldDescriptor::CPPTYPE_UINT32:
-      reflection->SetUInt32(message, field_desc, key.GetUInt32Value());
-      return;
-    case FieldDescriptor::CPPTYPE_BOOL:
-      reflection->SetBool(message, field_desc, key.GetBoolValue());
-      return;
-  }
-}
-
-void MapFieldPrinterHelper::CopyValue(const MapValueRef& value,
-                                      Message* message,
-                                      const FieldDescriptor* field_desc) {
-  const Reflection* reflection = message->GetReflection();
-  switch (field_desc->cpp_type()) {
-    case FieldDescriptor::CPPTYPE_DOUBLE:
-      reflection->SetDouble(message, field_desc, value.GetDoubleValue());
-      return;
-    case FieldDescriptor::CPPTYPE_FLOAT:
-      reflection->SetFloat(message, field_desc, value.GetFloatValue());
-      return;
-    case FieldDescriptor::CPPTYPE_ENUM:
-      reflection->SetEnumValue(message, field_desc, value.GetEnumValue());
-      return;
-    case FieldDescriptor::CPPTYPE_MESSAGE: {
-      Message* sub_message = value.GetMessageValue().New();
-      sub_message->CopyFrom(value.GetMessageValue());
-      reflection->SetAllocatedMessage(message, sub_message, field_desc);
-      return;
-    }
-    case FieldDescriptor::CPPTYPE_STRING:
-      reflection->SetString(message, field_desc, value.GetStringValue());
-      return;
-    case FieldDescriptor::CPPTYPE_INT64:
-      reflection->SetInt64(message, field_desc, value.GetInt64Value());
-      return;
-    case FieldDescriptor::CPPTYPE_INT32:
-      reflection->SetInt32(message, field_desc, value.GetInt32Value());
-      return;
-    case FieldDescriptor::CPPTYPE_UINT64:
-      reflection->SetUInt64(message, field_desc, value.GetUInt64Value());
-      return;
-    case FieldDescriptor::CPPTYPE_UINT32:
-      reflection->SetUInt32(message, field_desc, value.GetUInt32Value());
-      return;
-    case FieldDescriptor::CPPTYPE_BOOL:
-      reflection->SetBool(message, field_desc, value.GetBoolValue());
-      return;
-  }
+  return true;
 }
 }  // namespace internal
 
@@ -3726,12 +3724,19 @@ void TextFormat::Printer::PrintField(const Message& message,
     count = 1;
   }
 
+  if (field->is_repeated() && ShouldPrintInParallel(field, count)) {
+    PrintRepeatedMessageFieldInParallel(message, reflection, field, count,
+                                        generator);
+    return;
+  }
+
   std::vector<const Message*> sorted_map_field;
-  bool need_release = false;
+  std::unique_ptr<internal::MapEntryReader> map_entries;
   bool is_map = field->is_map();
-  if (is_map) {
-    need_release = internal::MapFieldPrinterHelper::SortMap(
-        message, reflection, field, &sorted_map_field);
+  if (is_map && !internal::MapFieldPrinterHelper::SortMap(
+                    message, reflection, field, &sorted_map_field)) {
+    map_entries = std::make_unique<internal::MapEntryReader>(
+        message, field, /*sorted=*/true);
   }
 
   for (int j = 0; j < count; ++j) {
@@ -3747,7 +3752,8 @@ void TextFormat::Printer::PrintField(const Message& message,
       const FastFieldValuePrinter* printer = GetFieldPrinter(field);
       const Message& sub_message =
           field->is_repeated()
-              ? (is_map ? *sorted_map_field[j]
+              ? (is_map ? (map_entries != nullptr ? *map_entries->Next()
+                                                  : *sorted_map_field[j])
                         : reflection->GetRepeatedMessage(message, field, j))
               : reflection->GetMessage(message, field);
       printer->PrintMessageStart(sub_message, field_index, count,
@@ -3772,10 +3778,74 @@ void TextFormat::Printer::PrintField(const Message& message,
     }
   }
 
-  if (need_release) {
-    for (const Message* message_to_delete : sorted_map_field) {
-      delete message_to_delete;
+}
+
+namespace {
+// Set while a thread prints a chunk of a repeated field, so that nested
+// repeated fields are printed serially instead of spawning more threads.
+PROTOBUF_THREAD_LOCAL bool printing_parallel_chunk = false;
+}  // namespace
+
+bool TextFormat::Printer::ShouldPrintInParallel(const FieldDescriptor* field,
+                                                int count) const {
+  return parallel_print_threads_ > 1 &&
+         count >= std::max(parallel_print_min_elements_, 2) &&
+         field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+         !field->is_map() && custom_printers_.empty() &&
+         custom_message_printers_.empty() && !insert_silent_marker_ &&
+         !redact_debug_string_ && !printing_parallel_chunk;
+}
+
+void TextFormat::Printer::PrintRepeatedMessageFieldInParallel(
+    const Message& message, const Reflection* reflection,
+    const FieldDescriptor* field, int count,
+    BaseTextGenerator* generator) const {
+  const int num_chunks = std::min(parallel_print_threads_, count);
+  std::vector<std::string> chunks(num_chunks);
+
+  auto print_chunk = [&](int chunk) {
+    bool was_printing_chunk = printing_parallel_chunk;
+    printing_parallel_chunk = true;
+    {
+      // Chunks are printed without indentation: splicing them through
+      // `generator` indents every line by its current level.
+      io::StringOutputStream output(&chunks[chunk]);
+      TextGenerator chunk_generator(&output, /*initial_indent_level=*/0);
+      const FastFieldValuePrinter* printer = GetFieldPrinter(field);
+      int begin = static_cast<int>(int64_t{count} * chunk / num_chunks);
+      int end = static_cast<int>(int64_t{count} * (chunk + 1) / num_chunks);
+      for (int j = begin; j < end; ++j) {
+        PrintFieldName(message, j, count, reflection, field, &chunk_generator);
+        const Message& sub_message =
+            reflection->GetRepeatedMessage(message, field, j);
+        printer->PrintMessageStart(sub_message, j, count, single_line_mode_,
+                                   &chunk_generator);
+        chunk_generator.Indent();
+        if (!printer->PrintMessageContent(sub_message, j, count,
+                                          single_line_mode_,
+                                          &chunk_generator)) {
+          Print(sub_message, &chunk_generator);
+        }
+        chunk_generator.Outdent();
+        printer->PrintMessageEnd(sub_message, j, count, single_line_mode_,
+                                 &chunk_generator);
+      }
     }
+    printing_parallel_chunk = was_printing_chunk;
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_chunks - 1);
+  for (int chunk = 1; chunk < num_chunks; ++chunk) {
+    threads.emplace_back(print_chunk, chunk);
+  }
+  print_chunk(0);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (const std::string& chunk : chunks) {
+    generator->Print(chunk.data(), chunk.size());
   }
 }
 
@@ -3806,7 +3876,7 @@ void TextFormat::Printer::PrintFieldName(const Message& message,
   // if use_field_number_ is true, prints field number instead
   // of field name.
   if (use_field_number_) {
-    generator->PrintString(absl::StrCat(field->number()));
+    generator->PrintString(absl::AlphaNum(field->number()).Piece());
     return;
   }
 
@@ -4014,7 +4084,7 @@ void TextFormat::Printer::PrintUnknownFields(
           // This field is not parseable as a Message (or we ran out of
           // recursion budget). So it is probably just a plain string.
           generator->PrintMaybeWithMarker(MarkerToken(), ": ", "\"");
-          generator->PrintString(absl::CEscape(value));
+          PrintCEscaped(value, /*utf8_safe=*/false, generator);
           if (single_line_mode_) {
             generator->PrintLiteral("\" ");
           } else {
@@ -1583,6 +1583,19 @@ class PROTOBUF_EXPORT TextFormat {
       truncate_string_field_longer_than_ = truncate_string_field_longer_than;
     }
 
+    // If |num_threads| is greater than 1, repeated message fields with at
+    // least |min_elements| elements are printed in contiguous chunks on up to
+    // |num_threads| threads, and the chunks are spliced back in order. The
+    // output is identical to serial printing.
+    //
+    // Parallel printing is only used when no custom field value or message
+    // printers are registered, since those are not required to be
+    // thread-safe.
+    void SetParallelRepeatedFieldPrinting(int num_threads, int min_elements) {
+      parallel_print_threads_ = num_threads;
+      parallel_print_min_elements_ = min_elements;
+    }
+
     // Sets whether sensitive fields found in the message will be reported or
     // not.
     void SetReportSensitiveFields(internal::FieldReporterLevel reporter) {
@@ -1659,6 +1672,17 @@ class PROTOBUF_EXPORT TextFormat {
                     const FieldDescriptor* field,
                     BaseTextGenerator* generator) const;
 
+    // Returns true if the |count| elements of |field| should be printed by
+    // PrintRepeatedMessageFieldInParallel().
+    bool ShouldPrintInParallel(const FieldDescriptor* field, int count) const;
+
+    // Print a large repeated message field in chunks on multiple threads.
+    void PrintRepeatedMessageFieldInParallel(const Message& message,
+                                             const Reflection* reflection,
+                                             const FieldDescriptor* field,
+                                             int count,
+                                             BaseTextGenerator* generator) const;
+
     // Print a repeated primitive field in short form.
     void PrintShortRepeatedField(const Message& message,
                                  const Reflection* reflection,
@@ -1713,6 +1737,8 @@ class PROTOBUF_EXPORT TextFormat {
     bool print_message_fields_in_index_order_;
     bool expand_any_;
     int64_t truncate_string_field_longer_than_;
+    int parallel_print_threads_;
+    int parallel_print_min_elements_;
 
     std::unique_ptr<const FastFieldValuePrinter> default_field_value_printer_;
     absl::flat_hash_map<const FieldDescriptor*,
@@ -1286,6 +1286,15 @@ class PROTOBUF_EXPORT ThreadSafeArena {
 
   std::vector<void*> PeekCleanupListForTesting();
 
+  // Whether repeated fields on this arena create new elements a chunk at a
+  // time. See ArenaOptions::contiguous_repeated_elements.
+  bool contiguous_repeated_elements() const {
+    return alloc_policy_.contiguous_repeated_elements();
+  }
+  void set_contiguous_repeated_elements(bool v) {
+    alloc_policy_.set_contiguous_repeated_elements(v);
+  }
+
  private:
   friend class ArenaBenchmark;
   friend class TcParser;
@@ -7,6 +7,7 @@
 
 #include "google_protobuf_util_field_mask_util.hpp"
 
+#include <climits>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -21,7 +22,14 @@
 #include <CppAbseil/absl_strings_str_split.hpp>
 #include <CppAbseil/absl_strings_string_view.hpp>
 #include <CppAbseil/absl_strings_strip.hpp>
+#include "google_protobuf_descriptor.pb.hpp"
+#include "google_protobuf_io_coded_stream.hpp"
+#include "google_protobuf_json_internal_unparser.hpp"
+#include "google_protobuf_json_json.hpp"
 #include "google_protobuf_message.hpp"
+#include "google_protobuf_unknown_field_set.hpp"
+#include "google_protobuf_wire_format.hpp"
+#include "google_protobuf_wire_format_lite.hpp"
 
 // Must be included last.
 
@@ -1341,6 +1349,94 @@ void FieldMaskUtil::GetFieldMaskForAllFields(const Descriptor* descriptor,
 }
 
 namespace {
+// Merges a field that is selected as a whole by a field mask.
+void MergeField(const Message& source, const Reflection* source_reflection,
+                const FieldDescriptor* field,
+                const FieldMaskUtil::MergeOptions& options,
+                Message* destination,
+                const Reflection* destination_reflection) {
+  if (!field->is_repeated()) {
+    switch (field->cpp_type()) {
+#define COPY_VALUE(TYPE, Name)                                              \
+  case FieldDescriptor::CPPTYPE_##TYPE: {                                   \
+    if (source_reflection->HasField(source, field)) {                       \
+      destination_reflection->Set##Name(                                    \
+          destination, field, source_reflection->Get##Name(source, field)); \
+    } else {                                                                \
+      destination_reflection->ClearField(destination, field);               \
+    }                                                                       \
+    break;                                                                  \
+  }
+      COPY_VALUE(BOOL, Bool)
+      COPY_VALUE(INT32, Int32)
+      COPY_VALUE(INT64, Int64)
+      COPY_VALUE(UINT32, UInt32)
+      COPY_VALUE(UINT64, UInt64)
+      COPY_VALUE(FLOAT, Float)
+      COPY_VALUE(DOUBLE, Double)
+      COPY_VALUE(ENUM, Enum)
+      COPY_VALUE(STRING, String)
+#undef COPY_VALUE
+      case FieldDescriptor::CPPTYPE_MESSAGE: {
+        if (options.replace_message_fields()) {
+          destination_reflection->ClearField(destination, field);
+        }
+        if (source_reflection->HasField(source, field)) {
+          destination_reflection->MutableMessage(destination, field)
+              ->MergeFrom(source_reflection->GetMessage(source, field));
+        }
+        break;
+      }
+    }
+  } else {
+    if (options.replace_repeated_fields()) {
+      destination_reflection->ClearField(destination, field);
+    }
+    switch (field->cpp_type()) {
+#define COPY_REPEATED_VALUE(TYPE, Name)                            \
+  case FieldDescriptor::CPPTYPE_##TYPE: {                          \
+    int size = source_reflection->FieldSize(source, field);        \
+    for (int i = 0; i < size; ++i) {                               \
+      destination_reflection->Add##Name(                           \
+          destination, field,                                      \
+          source_reflection->GetRepeated##Name(source, field, i)); \
+    }                                                              \
+    break;                                                         \
+  }
+      COPY_REPEATED_VALUE(BOOL, Bool)
+      COPY_REPEATED_VALUE(INT32, Int32)
+      COPY_REPEATED_VALUE(INT64, Int64)
+      COPY_REPEATED_VALUE(UINT32, UInt32)
+      COPY_REPEATED_VALUE(UINT64, UInt64)
+      COPY_REPEATED_VALUE(FLOAT, Float)
+      COPY_REPEATED_VALUE(DOUBLE, Double)
+      COPY_REPEATED_VALUE(ENUM, Enum)
+      COPY_REPEATED_VALUE(STRING, String)
+#undef COPY_REPEATED_VALUE
+      case FieldDescriptor::CPPTYPE_MESSAGE: {
+        int size = source_reflection->FieldSize(source, field);
+        for (int i = 0; i < size; ++i) {
+          destination_reflection->AddMessage(destination, field)
+              ->MergeFrom(
+                  source_reflection->GetRepeatedMessage(source, field, i));
+        }
+        break;
+      }
+    }
+  }
+}
+
+// Clears a field that is not selected by a field mask. Returns true if the
+// field was set.
+bool ClearField(const FieldDescriptor* field, const Reflection* reflection,
+                Message* message) {
+  bool modified = field->is_repeated()
+                      ? reflection->FieldSize(*message, field) != 0
+                      : reflection->HasField(*message, field);
+  reflection->ClearField(message, field);
+  return modified;
+}
+
 // A FieldMaskTree represents a FieldMask in a tree structure. For example,
 // given a FieldMask "foo.bar,foo.baz,bar.baz", the FieldMaskTree will be:
 //
@@ -1361,6 +1457,8 @@ class FieldMaskTree {
   void MergeFromFieldMask(const FieldMask& mask);
   void MergeToFieldMask(FieldMask* mask);
 
+  bool empty() const { return root_.children.empty(); }
+
   // Add a field path into the tree. In a FieldMask, each field path matches
   // the specified field and also all its sub-fields. If the field path to
   // add is a sub-path of an existing field path in the tree (i.e., a leaf
@@ -1636,75 +1734,8 @@ void FieldMaskTree::MergeMessage(const Node* node, const Message& source,
                    destination_reflection->MutableMessage(destination, field));
       continue;
     }
-    if (!field->is_repeated()) {
-      switch (field->cpp_type()) {
-#define COPY_VALUE(TYPE, Name)                                              \
-  case FieldDescriptor::CPPTYPE_##TYPE: {                                   \
-    if (source_reflection->HasField(source, field)) {                       \
-      destination_reflection->Set##Name(                                    \
-          destination, field, source_reflection->Get##Name(source, field)); \
-    } else {                                                                \
-      destination_reflection->ClearField(destination, field);               \
-    }                                                                       \
-    break;                                                                  \
-  }
-        COPY_VALUE(BOOL, Bool)
-        COPY_VALUE(INT32, Int32)
-        COPY_VALUE(INT64, Int64)
-        COPY_VALUE(UINT32, UInt32)
-        COPY_VALUE(UINT64, UInt64)
-        COPY_VALUE(FLOAT, Float)
-        COPY_VALUE(DOUBLE, Double)
-        COPY_VALUE(ENUM, Enum)
-        COPY_VALUE(STRING, String)
-#undef COPY_VALUE
-        case FieldDescriptor::CPPTYPE_MESSAGE: {
-          if (options.replace_message_fields()) {
-            destination_reflection->ClearField(destination, field);
-          }
-          if (source_reflection->HasField(source, field)) {
-            destination_reflection->MutableMessage(destination, field)
-                ->MergeFrom(source_reflection->GetMessage(source, field));
-          }
-          break;
-        }
-      }
-    } else {
-      if (options.replace_repeated_fields()) {
-        destination_reflection->ClearField(destination, field);
-      }
-      switch (field->cpp_type()) {
-#define COPY_REPEATED_VALUE(TYPE, Name)                            \
-  case FieldDescriptor::CPPTYPE_##TYPE: {                          \
-    int size = source_reflection->FieldSize(source, field);        \
-    for (int i = 0; i < size; ++i) {                               \
-      destination_reflection->Add##Name(                           \
-          destination, field,                                      \
-          source_reflection->GetRepeated##Name(source, field, i)); \
-    }                                                              \
-    break;                                                         \
-  }
-        COPY_REPEATED_VALUE(BOOL, Bool)
-        COPY_REPEATED_VALUE(INT32, Int32)
-        COPY_REPEATED_VALUE(INT64, Int64)
-        COPY_REPEATED_VALUE(UINT32, UInt32)
-        COPY_REPEATED_VALUE(UINT64, UInt64)
-        COPY_REPEATED_VALUE(FLOAT, Float)
-        COPY_REPEATED_VALUE(DOUBLE, Double)
-        COPY_REPEATED_VALUE(ENUM, Enum)
-        COPY_REPEATED_VALUE(STRING, String)
-#undef COPY_REPEATED_VALUE
-        case FieldDescriptor::CPPTYPE_MESSAGE: {
-          int size = source_reflection->FieldSize(source, field);
-          for (int i = 0; i < size; ++i) {
-            destination_reflection->AddMessage(destination, field)
-                ->MergeFrom(
-                    source_reflection->GetRepeatedMessage(source, field, i));
-          }
-          break;
-        }
-      }
-    }
+    MergeField(source, source_reflection, field, options, destination,
+               destination_reflection);
   }
 }
 
@@ -1752,16 +1783,7 @@ bool FieldMaskTree::TrimMessage(const Node* node, Message* message) {
     const FieldDescriptor* field = descriptor->field(index);
     auto it = node->children.find(field->name());
     if (it == node->children.end()) {
-      if (field->is_repeated()) {
-        if (reflection->FieldSize(*message, field) != 0) {
-          modified = true;
-        }
-      } else {
-        if (reflection->HasField(*message, field)) {
-          modified = true;
-        }
-      }
-      reflection->ClearField(message, field);
+      modified = ClearField(field, reflection, message) || modified;
     } else {
       if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
         Node* child = it->second.get();
@@ -1872,6 +1894,325 @@ bool FieldMaskUtil::TrimMessage(const FieldMask& mask, Message* message,
   return tree.TrimMessage(ABSL_DIE_IF_NULL(message));
 }
 
+struct FieldMaskUtil::CompiledFieldMask::Node : json_internal::FieldFilter {
+  struct Child {
+    const FieldDescriptor* field;
+    // The selected sub-fields of field, or null if all of field is selected.
+    std::unique_ptr<Node> node;
+  };
+
+  explicit Node(const Descriptor* descriptor) {
+    if (descriptor != nullptr) {
+      child_index.assign(descriptor->field_count(), -1);
+    }
+  }
+
+  // Returns the selected sub-fields of a singular message field, or null if
+  // the field is selected as a whole or not at all.
+  const Node* SubFields(const FieldDescriptor* field) const {
+    if (field->is_extension() || field->is_repeated() ||
+        field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+      return nullptr;
+    }
+    const int index = child_index[field->index()];
+    return index < 0 ? nullptr : children[index].node.get();
+  }
+
+  bool IsSelected(int field_number) const override {
+    for (const Child& child : children) {
+      if (child.field->number() == field_number) return true;
+    }
+    return false;
+  }
+
+  const FieldFilter* ForMessageField(int field_number) const override {
+    for (const Child& child : children) {
+      if (child.field->number() == field_number) {
+        return SubFields(child.field);
+      }
+    }
+    return nullptr;
+  }
+
+  // In the order in which FieldMaskTree visits them.
+  std::vector<Child> children;
+  // Maps FieldDescriptor::index() to an index into children, or -1 if the
+  // field is not selected. Empty for nodes below non-message fields.
+  std::vector<int> child_index;
+};
+
+FieldMaskUtil::CompiledFieldMask::CompiledFieldMask(
+    const Descriptor* descriptor, const FieldMask& mask)
+    : descriptor_(ABSL_DIE_IF_NULL(descriptor)) {
+  FieldMaskTree tree;
+  tree.MergeFromFieldMask(mask);
+  if (tree.empty()) return;
+  FieldMask canonical_mask;
+  tree.MergeToFieldMask(&canonical_mask);
+  root_ = Compile(descriptor, canonical_mask);
+
+  tree.AddRequiredFieldPath(descriptor);
+  FieldMask with_required_fields;
+  tree.MergeToFieldMask(&with_required_fields);
+  if (with_required_fields.paths_size() != canonical_mask.paths_size()) {
+    root_with_required_fields_ = Compile(descriptor, with_required_fields);
+  }
+}
+
+FieldMaskUtil::CompiledFieldMask::~CompiledFieldMask() {}
+
+std::unique_ptr<FieldMaskUtil::CompiledFieldMask::Node>
+FieldMaskUtil::CompiledFieldMask::Compile(const Descriptor* descriptor,
+                                          const FieldMask& canonical_mask) {
+  auto root = absl::make_unique<Node>(descriptor);
+  for (const std::string& path : canonical_mask.paths()) {
+    std::vector<absl::string_view> parts = absl::StrSplit(path, '.');
+    Node* node = root.get();
+    const Descriptor* current_descriptor = descriptor;
+    for (size_t i = 0; i < parts.size(); ++i) {
+      if (current_descriptor == nullptr) {
+        ABSL_LOG(ERROR) << "Field \"" << parts[i - 1] << "\" in path \""
+                        << path << "\" is not a singular message field and "
+                        << "cannot have sub-fields.";
+        break;
+      }
+      const FieldDescriptor* field =
+          current_descriptor->FindFieldByName(parts[i]);
+      if (field == nullptr) {
+        ABSL_LOG(ERROR) << "Cannot find field \"" << parts[i]
+                        << "\" in message " << current_descriptor->full_name();
+        break;
+      }
+      int& index = node->child_index[field->index()];
+      if (index < 0) {
+        index = static_cast<int>(node->children.size());
+        node->children.push_back({field, nullptr});
+      }
+      if (i + 1 == parts.size()) break;
+      current_descriptor =
+          !field->is_repeated() &&
+                  field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE
+              ? field->message_type()
+              : nullptr;
+      std::unique_ptr<Node>& child = node->children[index].node;
+      if (child == nullptr) {
+        child = absl::make_unique<Node>(current_descriptor);
+      }
+      node = child.get();
+    }
+  }
+  return root;
+}
+
+void FieldMaskUtil::CompiledFieldMask::MergeMessage(
+    const Node* node, const Message& source, const MergeOptions& options,
+    Message* destination) {
+  const Reflection* source_reflection = source.GetReflection();
+  const Reflection* destination_reflection = destination->GetReflection();
+  for (const Node::Child& child : node->children) {
+    const FieldDescriptor* field = child.field;
+    if (child.node == nullptr) {
+      MergeField(source, source_reflection, field, options, destination,
+                 destination_reflection);
+    } else if (!field->is_repeated() &&
+               field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      MergeMessage(child.node.get(),
+                   source_reflection->GetMessage(source, field), options,
+                   destination_reflection->MutableMessage(destination, field));
+    }
+  }
+}
+
+bool FieldMaskUtil::CompiledFieldMask::TrimMessage(const Node* node,
+                                                   Message* message) {
+  const Reflection* reflection = message->GetReflection();
+  const Descriptor* descriptor = message->GetDescriptor();
+  const int field_count = descriptor->field_count();
+  bool modified = false;
+  for (int index = 0; index < field_count; ++index) {
+    const FieldDescriptor* field = descriptor->field(index);
+    const int child_index = node->child_index[index];
+    if (child_index < 0) {
+      modified = ClearField(field, reflection, message) || modified;
+      continue;
+    }
+    const Node* child = node->children[child_index].node.get();
+    if (child != nullptr && !field->is_repeated() &&
+        field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+        reflection->HasField(*message, field)) {
+      modified =
+          TrimMessage(child, reflection->MutableMessage(message, field)) ||
+          modified;
+    }
+  }
+  return modified;
+}
+
+void FieldMaskUtil::MergeMessageTo(const Message& source,
+                                   const CompiledFieldMask& mask,
+                                   const MergeOptions& options,
+                                   Message* destination) {
+  ABSL_CHECK(source.GetDescriptor() == mask.descriptor());
+  ABSL_CHECK(destination->GetDescriptor() == mask.descriptor());
+  if (mask.empty()) return;
+  CompiledFieldMask::MergeMessage(mask.root_.get(), source, options,
+                                  destination);
+}
+
+bool FieldMaskUtil::TrimMessage(const CompiledFieldMask& mask,
+                                Message* message) {
+  ABSL_CHECK(ABSL_DIE_IF_NULL(message)->GetDescriptor() == mask.descriptor());
+  if (mask.empty()) return false;
+  return CompiledFieldMask::TrimMessage(mask.root_.get(), message);
+}
+
+bool FieldMaskUtil::TrimMessage(const CompiledFieldMask& mask, Message* message,
+                                const TrimOptions& options) {
+  ABSL_CHECK(ABSL_DIE_IF_NULL(message)->GetDescriptor() == mask.descriptor());
+  if (mask.empty()) return false;
+  const CompiledFieldMask::Node* root =
+      options.keep_required_fields() &&
+              mask.root_with_required_fields_ != nullptr
+          ? mask.root_with_required_fields_.get()
+          : mask.root_.get();
+  return CompiledFieldMask::TrimMessage(root, message);
+}
+
+size_t FieldMaskUtil::CompiledFieldMask::ByteSize(const Node* node,
+                                                  const Message& message,
+                                                  std::vector<size_t>* sizes) {
+  const Reflection* reflection = message.GetReflection();
+  std::vector<const FieldDescriptor*> fields;
+  reflection->ListFields(message, &fields);
+  size_t size = 0;
+  for (const FieldDescriptor* field : fields) {
+    // TrimMessage() leaves extensions alone.
+    if (!field->is_extension() && node->child_index[field->index()] < 0) {
+      continue;
+    }
+    const Node* sub_fields = node->SubFields(field);
+    if (sub_fields == nullptr) {
+      size += internal::WireFormat::FieldByteSize(field, message);
+      continue;
+    }
+    const size_t index = sizes->size();
+    sizes->push_back(0);
+    const size_t sub_size =
+        ByteSize(sub_fields, reflection->GetMessage(message, field), sizes);
+    (*sizes)[index] = sub_size;
+    size += internal::WireFormat::TagSize(field->number(), field->type()) +
+            sub_size;
+    if (field->type() != FieldDescriptor::TYPE_GROUP) {
+      size += io::CodedOutputStream::VarintSize64(sub_size);
+    }
+  }
+
+  const UnknownFieldSet& unknown_fields = reflection->GetUnknownFields(message);
+  if (message.GetDescriptor()->options().message_set_wire_format()) {
+    size += internal::WireFormat::ComputeUnknownMessageSetItemsSize(
+        unknown_fields);
+  } else {
+    size += internal::WireFormat::ComputeUnknownFieldsSize(unknown_fields);
+  }
+  return size;
+}
+
+uint8_t* FieldMaskUtil::CompiledFieldMask::Serialize(
+    const Node* node, const Message& message, const size_t** sizes,
+    uint8_t* target, io::EpsCopyOutputStream* stream) {
+  using internal::WireFormatLite;
+  const Reflection* reflection = message.GetReflection();
+  std::vector<const FieldDescriptor*> fields;
+  reflection->ListFields(message, &fields);
+  for (const FieldDescriptor* field : fields) {
+    if (!field->is_extension() && node->child_index[field->index()] < 0) {
+      continue;
+    }
+    const Node* sub_fields = node->SubFields(field);
+    if (sub_fields == nullptr) {
+      target = internal::WireFormat::InternalSerializeField(field, message,
+                                                            target, stream);
+      continue;
+    }
+    const size_t sub_size = *(*sizes)++;
+    const Message& sub_message = reflection->GetMessage(message, field);
+    target = stream->EnsureSpace(target);
+    if (field->type() == FieldDescriptor::TYPE_GROUP) {
+      target = WireFormatLite::WriteTagToArray(
+          field->number(), WireFormatLite::WIRETYPE_START_GROUP, target);
+      target = Serialize(sub_fields, sub_message, sizes, target, stream);
+      target = stream->EnsureSpace(target);
+      target = WireFormatLite::WriteTagToArray(
+          field->number(), WireFormatLite::WIRETYPE_END_GROUP, target);
+    } else {
+      target = WireFormatLite::WriteTagToArray(
+          field->number(), WireFormatLite::WIRETYPE_LENGTH_DELIMITED, target);
+      target = io::CodedOutputStream::WriteVarint32ToArray(
+          static_cast<uint32_t>(sub_size), target);
+      target = Serialize(sub_fields, sub_message, sizes, target, stream);
+    }
+  }
+
+  const UnknownFieldSet& unknown_fields = reflection->GetUnknownFields(message);
+  if (message.GetDescriptor()->options().message_set_wire_format()) {
+    return internal::WireFormat::InternalSerializeUnknownMessageSetItemsToArray(
+        unknown_fields, target, stream);
+  }
+  return internal::WireFormat::InternalSerializeUnknownFieldsToArray(
+      unknown_fields, target, stream);
+}
+
+bool FieldMaskUtil::SerializeMaskedToString(const Message& message,
+                                            const CompiledFieldMask& mask,
+                                            std::string* output) {
+  ABSL_CHECK(message.GetDescriptor() == mask.descriptor());
+  if (mask.empty()) {
+    return message.SerializePartialToString(output);
+  }
+  std::vector<size_t> sizes;
+  const size_t size =
+      CompiledFieldMask::ByteSize(mask.root_.get(), message, &sizes);
+  if (size > INT_MAX) {
+    ABSL_LOG(ERROR) << message.GetTypeName()
+                    << " exceeded maximum protobuf size of 2GB: " << size;
+    return false;
+  }
+  output->resize(size);
+  uint8_t* target = reinterpret_cast<uint8_t*>(&(*output)[0]);
+  io::EpsCopyOutputStream stream(
+      target, static_cast<int>(size),
+      io::CodedOutputStream::IsDefaultSerializationDeterministic());
+  const size_t* next_size = sizes.data();
+  uint8_t* end = CompiledFieldMask::Serialize(mask.root_.get(), message,
+                                              &next_size, target, &stream);
+  ABSL_DCHECK_EQ(end, target + size);
+  (void)end;
+  return true;
+}
+
+absl::Status FieldMaskUtil::MaskedMessageToJsonString(
+    const Message& message, const CompiledFieldMask& mask,
+    std::string* output) {
+  return MaskedMessageToJsonString(message, mask, output, json::PrintOptions());
+}
+
+absl::Status FieldMaskUtil::MaskedMessageToJsonString(
+    const Message& message, const CompiledFieldMask& mask, std::string* output,
+    const json::PrintOptions& options) {
+  ABSL_CHECK(message.GetDescriptor() == mask.descriptor());
+  json_internal::WriterOptions opts;
+  opts.add_whitespace = options.add_whitespace;
+  opts.preserve_proto_field_names = options.preserve_proto_field_names;
+  opts.always_print_enums_as_ints = options.always_print_enums_as_ints;
+  opts.always_print_primitive_fields = options.always_print_primitive_fields;
+  opts.unquote_int64_if_possible = options.unquote_int64_if_possible;
+  // Matches json::MessageToJsonString().
+  opts.allow_legacy_syntax = true;
+
+  return json_internal::MessageToJsonString(message, output, opts,
+                                            mask.root_.get());
+}
+
 }  // namespace util
 }  // namespace protobuf
 }  // namespace google
@@ -11,11 +11,13 @@
 #define GOOGLE_PROTOBUF_UTIL_FIELD_MASK_UTIL_H__
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <CppProtobuf/google_protobuf_field_mask.pb.hpp>
 #include <CppAbseil/absl_log_absl_check.hpp>
+#include <CppAbseil/absl_status_status.hpp>
 #include <CppAbseil/absl_strings_string_view.hpp>
 #include <CppProtobuf/google_protobuf_descriptor.hpp>
 
@@ -1206,6 +1208,10 @@ PROTOBUF_EXPORT void protobuf_assumption_failed(const char *pred,
 
 namespace google {
 namespace protobuf {
+namespace json {
+struct PrintOptions;
+}  // namespace json
+
 namespace util {
 
 class PROTOBUF_EXPORT FieldMaskUtil {
@@ -1340,6 +1346,37 @@ class PROTOBUF_EXPORT FieldMaskUtil {
   static bool TrimMessage(const FieldMask& mask, Message* message,
                           const TrimOptions& options);
 
+  class CompiledFieldMask;
+  // Same as above, but with a FieldMask that has been resolved against the
+  // message type up front. Prefer these when the same mask is applied to many
+  // messages.
+  static void MergeMessageTo(const Message& source,
+                             const CompiledFieldMask& mask,
+                             const MergeOptions& options, Message* destination);
+  static bool TrimMessage(const CompiledFieldMask& mask, Message* message);
+  static bool TrimMessage(const CompiledFieldMask& mask, Message* message,
+                          const TrimOptions& options);
+
+  // Serializes only the fields of 'message' that are represented in the given
+  // mask. The output is the same as that of trimming a copy of the message
+  // with TrimMessage() and serializing the copy, but no copy is made. Required
+  // fields are not checked. Returns false if the output would be larger than
+  // 2GB.
+  static bool SerializeMaskedToString(const Message& message,
+                                      const CompiledFieldMask& mask,
+                                      std::string* output);
+
+  // Prints the fields of 'message' that are represented in the given mask as
+  // JSON, like json::MessageToJsonString(). Fields outside the mask are not
+  // printed even if always_print_primitive_fields is set. Well-known types
+  // with a special JSON representation are always printed whole.
+  static absl::Status MaskedMessageToJsonString(const Message& message,
+                                                const CompiledFieldMask& mask,
+                                                std::string* output);
+  static absl::Status MaskedMessageToJsonString(
+      const Message& message, const CompiledFieldMask& mask,
+      std::string* output, const json::PrintOptions& options);
+
  private:
   friend class SnakeCaseCamelCaseTest;
   // Converts a field name from snake_case to camelCase:
@@ -1415,6 +1452,54 @@ class PROTOBUF_EXPORT FieldMaskUtil::TrimOptions {
   bool keep_required_fields_;
 };
 
+// A FieldMask whose paths have been resolved to FieldDescriptors of one
+// message type. Compiling a mask does the path parsing and field name lookups
+// that MergeMessageTo() and TrimMessage() would otherwise repeat on every call.
+// A CompiledFieldMask is immutable and may be shared between threads.
+//
+//   FieldMaskUtil::CompiledFieldMask compiled(Foo::descriptor(), mask);
+//   for (Foo* foo : foos) FieldMaskUtil::TrimMessage(compiled, foo);
+//
+// Paths that name unknown fields are handled as the FieldMask overloads
+// handle them, except that they are logged once, when the mask is compiled.
+class PROTOBUF_EXPORT FieldMaskUtil::CompiledFieldMask {
+ public:
+  CompiledFieldMask(const Descriptor* descriptor, const FieldMask& mask);
+  CompiledFieldMask(const CompiledFieldMask&) = delete;
+  CompiledFieldMask& operator=(const CompiledFieldMask&) = delete;
+  ~CompiledFieldMask();
+
+  // The message type the mask was compiled for.
+  const Descriptor* descriptor() const { return descriptor_; }
+
+  // Returns true if the mask has no paths.
+  bool empty() const { return root_ == nullptr; }
+
+ private:
+  friend class FieldMaskUtil;
+  struct Node;
+
+  static std::unique_ptr<Node> Compile(const Descriptor* descriptor,
+                                       const FieldMask& canonical_mask);
+  static void MergeMessage(const Node* node, const Message& source,
+                           const MergeOptions& options, Message* destination);
+  static bool TrimMessage(const Node* node, Message* message);
+  // The two passes of SerializeMaskedToString(). ByteSize() appends the sizes
+  // of the trimmed sub-messages to 'sizes' in the order in which Serialize()
+  // consumes them.
+  static size_t ByteSize(const Node* node, const Message& message,
+                         std::vector<size_t>* sizes);
+  static uint8_t* Serialize(const Node* node, const Message& message,
+                            const size_t** sizes, uint8_t* target,
+                            io::EpsCopyOutputStream* stream);
+
+  const Descriptor* descriptor_;
+  std::unique_ptr<Node> root_;
+  // The mask with the required fields of every message it reaches added, for
+  // TrimOptions::keep_required_fields(). Null if that adds nothing.
+  std::unique_ptr<Node> root_with_required_fields_;
+};
+
 }  // namespace util
 }  // namespace protobuf
 }  // namespace google
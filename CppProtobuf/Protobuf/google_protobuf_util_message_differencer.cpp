@@ -12,28 +12,36 @@
 #include "google_protobuf_util_message_differencer.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <climits>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <thread>
 #include <utility>
 
 #include "google_protobuf_descriptor.pb.hpp"
 #include <CppAbseil/absl_container_fixed_array.hpp>
 #include <CppAbseil/absl_container_flat_hash_map.hpp>
+#include <CppAbseil/absl_container_flat_hash_set.hpp>
+#include <CppAbseil/absl_hash_hash.hpp>
 #include <CppAbseil/absl_log_absl_check.hpp>
 #include <CppAbseil/absl_log_absl_log.hpp>
 #include <CppAbseil/absl_strings_escaping.hpp>
 #include <CppAbseil/absl_strings_match.hpp>
 #include <CppAbseil/absl_strings_str_cat.hpp>
 #include <CppAbseil/absl_strings_str_format.hpp>
+#include <CppAbseil/absl_synchronization_mutex.hpp>
 #include "google_protobuf_descriptor.hpp"
 #include "google_protobuf_dynamic_message.hpp"
 #include "google_protobuf_generated_enum_reflection.hpp"
+#include "google_protobuf_io_coded_stream.hpp"
 #include "google_protobuf_io_printer.hpp"
 #include "google_protobuf_io_zero_copy_stream.hpp"
 #include "google_protobuf_io_zero_copy_stream_impl.hpp"
+#include "google_protobuf_io_zero_copy_stream_impl_lite.hpp"
 #include "google_protobuf_map_field.hpp"
 #include "google_protobuf_message.hpp"
 #include "google_protobuf_text_format.hpp"
@@ -1247,6 +1255,92 @@ std::string PrintShortTextFormat(const google::protobuf::Message& message) {
   return debug_string;
 }
 
+// Returns true if two messages of this type with identical deterministic
+// serializations are equal under all the static comparison methods. That
+// fails for NaNs, which are never equal, and for Any payloads and extensions,
+// whose types the descriptor does not tell.
+bool ComputeSerializationDeterminesEquality(const Descriptor* descriptor) {
+  absl::flat_hash_set<const Descriptor*> seen = {descriptor};
+  std::vector<const Descriptor*> pending = {descriptor};
+  while (!pending.empty()) {
+    const Descriptor* type = pending.back();
+    pending.pop_back();
+    if (type->full_name() == internal::kAnyFullTypeName ||
+        type->extension_range_count() > 0) {
+      return false;
+    }
+    for (int i = 0; i < type->field_count(); ++i) {
+      const FieldDescriptor* field = type->field(i);
+      switch (field->cpp_type()) {
+        case FieldDescriptor::CPPTYPE_FLOAT:
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+          return false;
+        case FieldDescriptor::CPPTYPE_MESSAGE:
+          if (seen.insert(field->message_type()).second) {
+            pending.push_back(field->message_type());
+          }
+          break;
+        default:
+          break;
+      }
+    }
+  }
+  return true;
+}
+
+// Caches ComputeSerializationDeterminesEquality() per type. Only generated
+// types get here, and their descriptors live as long as the process, so they
+// can be keyed by address.
+bool SerializationDeterminesEquality(const Descriptor* descriptor) {
+  static absl::Mutex mu{absl::kConstInit};
+  static auto* const cache = new absl::flat_hash_map<const Descriptor*, bool>();
+  {
+    absl::ReaderMutexLock lock(&mu);
+    auto it = cache->find(descriptor);
+    if (it != cache->end()) return it->second;
+  }
+  const bool result = ComputeSerializationDeterminesEquality(descriptor);
+  absl::MutexLock lock(&mu);
+  cache->try_emplace(descriptor, result);
+  return result;
+}
+
+bool SerializeDeterministically(const Message& message, size_t size,
+                                std::string* output) {
+  output->resize(size);
+  io::ArrayOutputStream array(&(*output)[0], static_cast<int>(size));
+  io::CodedOutputStream coded_output(&array);
+  coded_output.SetSerializationDeterministic(true);
+  message.SerializeWithCachedSizes(&coded_output);
+  return !coded_output.HadError();
+}
+
+// Fast path of the static comparison methods. Returns true if the messages
+// are known to be equal because they serialize to the same bytes, and false
+// if they have to be compared field by field. Messages without generated code
+// serialize through reflection, which costs as much as comparing them, so
+// they always take the slow path.
+bool HaveIdenticalSerializations(const Message& message1,
+                                 const Message& message2) {
+  if (message1.GetDescriptor() != message2.GetDescriptor() ||
+      message1.GetReflection()->GetMessageFactory() !=
+          MessageFactory::generated_factory() ||
+      message2.GetReflection()->GetMessageFactory() !=
+          MessageFactory::generated_factory() ||
+      !SerializationDeterminesEquality(message1.GetDescriptor())) {
+    return false;
+  }
+  const size_t size = message1.ByteSizeLong();
+  if (size != message2.ByteSizeLong() || size > static_cast<size_t>(INT_MAX)) {
+    return false;
+  }
+  std::string bytes1;
+  std::string bytes2;
+  return SerializeDeterministically(message1, size, &bytes1) &&
+         SerializeDeterministically(message2, size, &bytes2) &&
+         bytes1 == bytes2;
+}
+
 }  // namespace
 
 // A reporter to report the total number of diffs.
@@ -1331,6 +1425,11 @@ class MessageDifferencer::MultipleFieldsMapKeyComparator
     return true;
   }
 
+  const std::vector<std::vector<const FieldDescriptor*> >& key_field_paths()
+      const {
+    return key_field_paths_;
+  }
+
  private:
   bool IsMatchInternal(
       const Message& message1, const Message& message2, int unpacked_any,
@@ -1378,6 +1477,67 @@ class MessageDifferencer::MultipleFieldsMapKeyComparator
   std::vector<std::vector<const FieldDescriptor*> > key_field_paths_;
 };
 
+class MessageDifferencer::BufferingReporter
+    : public MessageDifferencer::Reporter {
+ public:
+  void ReportAdded(const Message& message1, const Message& message2,
+                   const std::vector<SpecificField>& field_path) override {
+    Record(&Reporter::ReportAdded, message1, message2, field_path);
+  }
+  void ReportDeleted(const Message& message1, const Message& message2,
+                     const std::vector<SpecificField>& field_path) override {
+    Record(&Reporter::ReportDeleted, message1, message2, field_path);
+  }
+  void ReportModified(const Message& message1, const Message& message2,
+                      const std::vector<SpecificField>& field_path) override {
+    Record(&Reporter::ReportModified, message1, message2, field_path);
+  }
+  void ReportMoved(const Message& message1, const Message& message2,
+                   const std::vector<SpecificField>& field_path) override {
+    Record(&Reporter::ReportMoved, message1, message2, field_path);
+  }
+  void ReportMatched(const Message& message1, const Message& message2,
+                     const std::vector<SpecificField>& field_path) override {
+    Record(&Reporter::ReportMatched, message1, message2, field_path);
+  }
+  void ReportIgnored(const Message& message1, const Message& message2,
+                     const std::vector<SpecificField>& field_path) override {
+    Record(&Reporter::ReportIgnored, message1, message2, field_path);
+  }
+  void ReportUnknownFieldIgnored(
+      const Message& message1, const Message& message2,
+      const std::vector<SpecificField>& field_path) override {
+    Record(&Reporter::ReportUnknownFieldIgnored, message1, message2,
+           field_path);
+  }
+
+  // Calls the recorded reports on reporter, in the order they were made.
+  void Replay(Reporter* reporter) const {
+    for (const Report& report : reports_) {
+      (reporter->*report.method)(*report.message1, *report.message2,
+                                 report.field_path);
+    }
+  }
+
+ private:
+  using ReportMethod = void (Reporter::*)(const Message&, const Message&,
+                                          const std::vector<SpecificField>&);
+  struct Report {
+    ReportMethod method;
+    const Message* message1;
+    const Message* message2;
+    std::vector<SpecificField> field_path;
+  };
+
+  void Record(ReportMethod method, const Message& message1,
+              const Message& message2,
+              const std::vector<SpecificField>& field_path) {
+    reports_.push_back({method, &message1, &message2, field_path});
+  }
+
+  std::vector<Report> reports_;
+};
+
 // Preserve the order when treating repeated field as SMART_LIST. The current
 // implementation is to find the longest matching sequence from the first
 // element. The optimal solution requires to use //util/diff/lcs.h, which is
@@ -1449,6 +1609,9 @@ bool MessageDifferencer::MapEntryKeyComparator::IsMatch(
 
 bool MessageDifferencer::Equals(const Message& message1,
                                 const Message& message2) {
+  if (HaveIdenticalSerializations(message1, message2)) {
+    return true;
+  }
   MessageDifferencer differencer;
 
   return differencer.Compare(message1, message2);
@@ -1456,6 +1619,9 @@ bool MessageDifferencer::Equals(const Message& message1,
 
 bool MessageDifferencer::Equivalent(const Message& message1,
                                     const Message& message2) {
+  if (HaveIdenticalSerializations(message1, message2)) {
+    return true;
+  }
   MessageDifferencer differencer;
   differencer.set_message_field_comparison(MessageDifferencer::EQUIVALENT);
 
@@ -1464,6 +1630,9 @@ bool MessageDifferencer::Equivalent(const Message& message1,
 
 bool MessageDifferencer::ApproximatelyEquals(const Message& message1,
                                              const Message& message2) {
+  if (HaveIdenticalSerializations(message1, message2)) {
+    return true;
+  }
   MessageDifferencer differencer;
   differencer.set_float_comparison(MessageDifferencer::APPROXIMATE);
 
@@ -1472,6 +1641,9 @@ bool MessageDifferencer::ApproximatelyEquals(const Message& message1,
 
 bool MessageDifferencer::ApproximatelyEquivalent(const Message& message1,
                                                  const Message& message2) {
+  if (HaveIdenticalSerializations(message1, message2)) {
+    return true;
+  }
   MessageDifferencer differencer;
   differencer.set_message_field_comparison(MessageDifferencer::EQUIVALENT);
   differencer.set_float_comparison(MessageDifferencer::APPROXIMATE);
@@ -1800,7 +1972,13 @@ bool MessageDifferencer::Compare(const Message& message1,
     if (unpack_any_field_.UnpackAny(message1, &data1) &&
         unpack_any_field_.UnpackAny(message2, &data2) &&
         data1->GetDescriptor() == data2->GetDescriptor()) {
-      return Compare(*data1, *data2, unpacked_any + 1, parent_fields);
+      const bool result =
+          Compare(*data1, *data2, unpacked_any + 1, parent_fields);
+      if (parallel_task_ && reporter_ != nullptr) {
+        unpacked_any_messages_.push_back(std::move(data1));
+        unpacked_any_messages_.push_back(std::move(data2));
+      }
+      return result;
     }
     // If the Any payload is unparsable, or the payload types are different
     // between message1 and message2, fall through and treat Any as a regular
@@ -1971,6 +2149,11 @@ bool MessageDifferencer::CompareWithFieldsInternal(
     const std::vector<const FieldDescriptor*>& message1_fields,
     const std::vector<const FieldDescriptor*>& message2_fields,
     std::vector<SpecificField>* parent_fields) {
+  if (parallel_threads_ > 1 && parent_fields->empty()) {
+    return CompareFieldsInParallel(message1, message2, unpacked_any,
+                                   message1_fields, message2_fields);
+  }
+
   bool isDifferent = false;
   int field_index1 = 0;
   int field_index2 = 0;
@@ -2167,6 +2350,172 @@ bool MessageDifferencer::CompareWithFieldsInternal(
   return !isDifferent;
 }
 
+void MessageDifferencer::CopySettingsFrom(const MessageDifferencer& other) {
+  message_field_comparison_ = other.message_field_comparison_;
+  scope_ = other.scope_;
+  force_compare_no_presence_fields_ = other.force_compare_no_presence_fields_;
+  repeated_field_comparison_ = other.repeated_field_comparison_;
+  repeated_field_comparisons_ = other.repeated_field_comparisons_;
+  for (const auto& entry : other.map_field_key_comparator_) {
+    const MapKeyComparator* key_comparator = entry.second;
+    // Comparators created by TreatAsMap* call back into their differencer, so
+    // they cannot be shared.
+    if (std::find(other.owned_key_comparators_.begin(),
+                  other.owned_key_comparators_.end(),
+                  key_comparator) != other.owned_key_comparators_.end()) {
+      MapKeyComparator* copy = new MultipleFieldsMapKeyComparator(
+          this, static_cast<const MultipleFieldsMapKeyComparator*>(
+                    key_comparator)
+                    ->key_field_paths());
+      owned_key_comparators_.push_back(copy);
+      key_comparator = copy;
+    }
+    map_field_key_comparator_[entry.first] = key_comparator;
+  }
+  ignore_criteria_ = other.ignore_criteria_;
+  ignored_fields_ = other.ignored_fields_;
+  // The default comparator is only read while comparing, so it is shared.
+  field_comparator_ = other.field_comparator_;
+  field_comparator_kind_ = other.field_comparator_kind_;
+  report_matches_ = other.report_matches_;
+  report_moves_ = other.report_moves_;
+  report_ignores_ = other.report_ignores_;
+  force_compare_no_presence_ = other.force_compare_no_presence_;
+  match_indices_for_smart_list_callback_ =
+      other.match_indices_for_smart_list_callback_;
+}
+
+bool MessageDifferencer::CompareFieldsInParallel(
+    const Message& message1, const Message& message2, int unpacked_any,
+    const std::vector<const FieldDescriptor*>& message1_fields,
+    const std::vector<const FieldDescriptor*>& message2_fields) {
+  // Each task is one step of the merge in CompareWithFieldsInternal: a field
+  // that is in either or both of the lists. A repeated field compared as a
+  // list may be split into several tasks for ranges of its indices.
+  struct Task {
+    const FieldDescriptor* field1;
+    const FieldDescriptor* field2;
+    int begin;
+    int end;
+    bool different;
+  };
+  std::vector<Task> tasks;
+  const int chunk_size = parallel_min_chunk_elements_;
+  size_t index1 = 0;
+  size_t index2 = 0;
+  while (true) {
+    const FieldDescriptor* field1 = message1_fields[index1];
+    const FieldDescriptor* field2 = message2_fields[index2];
+    if (field1 == nullptr && field2 == nullptr) {
+      break;
+    }
+    if (FieldBefore(field1, field2)) {
+      tasks.push_back({field1, nullptr, -1, -1, false});
+      ++index1;
+      continue;
+    }
+    if (FieldBefore(field2, field1)) {
+      tasks.push_back({nullptr, field2, -1, -1, false});
+      ++index2;
+      continue;
+    }
+    ++index1;
+    ++index2;
+
+    if (chunk_size > 0 && field1->is_repeated() && !field1->is_map() &&
+        GetMapKeyComparator(field1) == nullptr && !IsTreatedAsSet(field1) &&
+        !IsTreatedAsSmartSet(field1) && !IsTreatedAsSmartList(field1)) {
+      const int count =
+          std::max(message1.GetReflection()->FieldSize(message1, field1),
+                   message2.GetReflection()->FieldSize(message2, field1));
+      // Ignored fields are reported as a whole by CompareWithFieldsInternal.
+      if (count / 2 >= chunk_size &&
+          !IsIgnored(message1, message2, field1, {})) {
+        for (int begin = 0; begin < count; begin += chunk_size) {
+          tasks.push_back({field1, field1, begin,
+                           begin + std::min(chunk_size, count - begin),
+                           false});
+        }
+        continue;
+      }
+    }
+    tasks.push_back({field1, field2, -1, -1, false});
+  }
+  if (tasks.empty()) {
+    return true;
+  }
+
+  // Without a reporter the first difference decides the result, and the
+  // remaining tasks are skipped.
+  std::vector<BufferingReporter> reporters(
+      reporter_ == nullptr ? 0 : tasks.size());
+  std::atomic<size_t> next_task{0};
+  std::atomic<bool> found_difference{false};
+  const int num_threads =
+      static_cast<int>(std::min<size_t>(parallel_threads_, tasks.size()));
+  // The workers hold the Any payloads that the buffered reports refer to, so
+  // they outlive the replay.
+  std::vector<std::unique_ptr<MessageDifferencer>> workers(num_threads);
+
+  auto run_tasks = [&](int thread) {
+    workers[thread] = std::make_unique<MessageDifferencer>();
+    MessageDifferencer& worker = *workers[thread];
+    worker.CopySettingsFrom(*this);
+    worker.parallel_task_ = true;
+    std::vector<SpecificField> parent_fields;
+    while (true) {
+      const size_t i = next_task.fetch_add(1, std::memory_order_relaxed);
+      if (i >= tasks.size() ||
+          (reporter_ == nullptr &&
+           found_difference.load(std::memory_order_relaxed))) {
+        break;
+      }
+      Task& task = tasks[i];
+      worker.reporter_ = reporter_ == nullptr ? nullptr : &reporters[i];
+      if (task.begin >= 0) {
+        task.different =
+            !worker.CompareListRange(message1, message2, unpacked_any,
+                                     task.field1, task.begin, task.end,
+                                     &parent_fields);
+      } else {
+        task.different = !worker.CompareWithFieldsInternal(
+            message1, message2, unpacked_any, {task.field1, nullptr},
+            {task.field2, nullptr}, &parent_fields);
+      }
+      if (task.different) {
+        found_difference.store(true, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (int thread = 1; thread < num_threads; ++thread) {
+    threads.emplace_back(run_tasks, thread);
+  }
+  run_tasks(0);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  bool isDifferent = false;
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    if (reporter_ != nullptr) {
+      reporters[i].Replay(reporter_);
+    }
+    isDifferent |= tasks[i].different;
+  }
+  for (const auto& worker : workers) {
+    force_compare_no_presence_fields_.insert(
+        worker->force_compare_no_presence_fields_.begin(),
+        worker->force_compare_no_presence_fields_.end());
+    force_compare_failure_triggering_fields_.insert(
+        worker->force_compare_failure_triggering_fields_.begin(),
+        worker->force_compare_failure_triggering_fields_.end());
+  }
+  return !isDifferent;
+}
+
 bool MessageDifferencer::IsMatch(
     const FieldDescriptor* repeated_field,
     const MapKeyComparator* key_comparator, const Message* message1,
@@ -2323,9 +2672,17 @@ bool MessageDifferencer::CompareMapField(
   const Reflection* reflection1 = message1.GetReflection();
   const Reflection* reflection2 = message2.GetReflection();
 
-  // When both map fields are on map, do not sync to repeated field.
-  if (reflection1->GetMapData(message1, repeated_field)->IsMapValid() &&
-      reflection2->GetMapData(message2, repeated_field)->IsMapValid() &&
+  // Compare the maps directly, so that neither map field has to build its
+  // repeated representation. Only when both repeated fields are up to date and
+  // a map is not is it cheaper to compare them as repeated fields.
+  const internal::MapFieldBase* map1 =
+      reflection1->GetMapData(message1, repeated_field);
+  const internal::MapFieldBase* map2 =
+      reflection2->GetMapData(message2, repeated_field);
+  const bool compare_maps =
+      (map1->IsMapValid() && map2->IsMapValid()) ||
+      !(map1->IsRepeatedFieldValid() && map2->IsRepeatedFieldValid());
+  if (compare_maps &&
       // TODO: Add support for reporter
       reporter_ == nullptr &&
       // Users didn't set custom map field key comparator
@@ -2397,21 +2754,22 @@ bool MessageDifferencer::CompareRepeatedRep(
 
   const MapKeyComparator* key_comparator = GetMapKeyComparator(repeated_field);
   bool smart_list = IsTreatedAsSmartList(repeated_field);
-  bool simple_list = key_comparator == nullptr &&
-                     !IsTreatedAsSet(repeated_field) &&
-                     !IsTreatedAsSmartSet(repeated_field) && !smart_list;
 
   // For simple lists, we avoid matching repeated field indices, saving the
   // memory allocations that would otherwise be needed for match_list1 and
   // match_list2.
-  if (!simple_list) {
-    // Try to match indices of the repeated fields. Return false if match fails.
-    if (!MatchRepeatedFieldIndices(
-            message1, message2, unpacked_any, repeated_field, key_comparator,
-            *parent_fields, &match_list1, &match_list2) &&
-        reporter_ == nullptr) {
-      return false;
-    }
+  if (key_comparator == nullptr && !IsTreatedAsSet(repeated_field) &&
+      !IsTreatedAsSmartSet(repeated_field) && !smart_list) {
+    return CompareListRange(message1, message2, unpacked_any, repeated_field,
+                            0, std::max(count1, count2), parent_fields);
+  }
+
+  // Try to match indices of the repeated fields. Return false if match fails.
+  if (!MatchRepeatedFieldIndices(message1, message2, unpacked_any,
+                                 repeated_field, key_comparator,
+                                 *parent_fields, &match_list1, &match_list2) &&
+      reporter_ == nullptr) {
+    return false;
   }
 
   bool fieldDifferent = false;
@@ -2425,10 +2783,7 @@ bool MessageDifferencer::CompareRepeatedRep(
   // to be done later). Now to check if the paired elements are different.
   int next_unmatched_index = 0;
   for (int i = 0; i < count1; i++) {
-    if (simple_list && i >= count2) {
-      break;
-    }
-    if (!simple_list && match_list1[i] == -1) {
+    if (match_list1[i] == -1) {
       if (smart_list) {
         if (reporter_ == nullptr) return false;
         AddSpecificIndex(&specific_field, message1, repeated_field, i);
@@ -2456,13 +2811,9 @@ bool MessageDifferencer::CompareRepeatedRep(
       }
     }
     AddSpecificIndex(&specific_field, message1, repeated_field, i);
-    if (simple_list) {
-      AddSpecificNewIndex(&specific_field, message2, repeated_field, i);
-    } else {
-      AddSpecificNewIndex(&specific_field, message2, repeated_field,
-                          match_list1[i]);
-      next_unmatched_index = match_list1[i] + 1;
-    }
+    AddSpecificNewIndex(&specific_field, message2, repeated_field,
+                        match_list1[i]);
+    next_unmatched_index = match_list1[i] + 1;
 
     const bool result = CompareFieldValueUsingParentFields(
         message1, message2, unpacked_any, repeated_field, i,
@@ -2492,8 +2843,7 @@ bool MessageDifferencer::CompareRepeatedRep(
 
   // Report any remaining additions or deletions.
   for (int i = 0; i < count2; ++i) {
-    if (!simple_list && match_list2[i] != -1) continue;
-    if (simple_list && i < count1) continue;
+    if (match_list2[i] != -1) continue;
     if (!treated_as_subset) {
       fieldDifferent = true;
     }
@@ -2507,8 +2857,7 @@ bool MessageDifferencer::CompareRepeatedRep(
   }
 
   for (int i = 0; i < count1; ++i) {
-    if (!simple_list && match_list1[i] != -1) continue;
-    if (simple_list && i < count2) continue;
+    if (match_list1[i] != -1) continue;
     assert(reporter_ != NULL);
     AddSpecificIndex(&specific_field, message1, repeated_field, i);
     parent_fields->push_back(specific_field);
@@ -2519,6 +2868,69 @@ bool MessageDifferencer::CompareRepeatedRep(
   return !fieldDifferent;
 }
 
+bool MessageDifferencer::CompareListRange(
+    const Message& message1, const Message& message2, int unpacked_any,
+    const FieldDescriptor* repeated_field, int begin, int end,
+    std::vector<SpecificField>* parent_fields) {
+  const int count1 =
+      message1.GetReflection()->FieldSize(message1, repeated_field);
+  const int count2 =
+      message2.GetReflection()->FieldSize(message2, repeated_field);
+
+  bool fieldDifferent = false;
+  SpecificField specific_field;
+  specific_field.message1 = &message1;
+  specific_field.message2 = &message2;
+  specific_field.unpacked_any = unpacked_any;
+  specific_field.field = repeated_field;
+
+  for (int i = begin; i < end; ++i) {
+    if (i >= count1) {
+      // Elements past the end of message1 were added.
+      if (reporter_ == nullptr) return false;
+      specific_field.index = i;
+      AddSpecificNewIndex(&specific_field, message2, repeated_field, i);
+      parent_fields->push_back(specific_field);
+      reporter_->ReportAdded(message1, message2, *parent_fields);
+      parent_fields->pop_back();
+      fieldDifferent = true;
+      continue;
+    }
+    if (i >= count2) {
+      // Elements past the end of message2 were deleted. new_index keeps the
+      // last index both fields have, as it always did for deletions.
+      if (reporter_ == nullptr) return false;
+      AddSpecificIndex(&specific_field, message1, repeated_field, i);
+      specific_field.new_index = count2 - 1;
+      parent_fields->push_back(specific_field);
+      reporter_->ReportDeleted(message1, message2, *parent_fields);
+      parent_fields->pop_back();
+      fieldDifferent = true;
+      continue;
+    }
+
+    AddSpecificIndex(&specific_field, message1, repeated_field, i);
+    AddSpecificNewIndex(&specific_field, message2, repeated_field, i);
+    const bool result = CompareFieldValueUsingParentFields(
+        message1, message2, unpacked_any, repeated_field, i, i, parent_fields);
+
+    // Elements are compared at the same index, so they are never reported as
+    // moved.
+    if (!result) {
+      if (reporter_ == nullptr) return false;
+      parent_fields->push_back(specific_field);
+      reporter_->ReportModified(message1, message2, *parent_fields);
+      parent_fields->pop_back();
+      fieldDifferent = true;
+    } else if (report_matches_ && reporter_ != nullptr) {
+      parent_fields->push_back(specific_field);
+      reporter_->ReportMatched(message1, message2, *parent_fields);
+      parent_fields->pop_back();
+    }
+  }
+  return !fieldDifferent;
+}
+
 bool MessageDifferencer::CompareFieldValue(const Message& message1,
                                            const Message& message2,
                                            int unpacked_any,
@@ -3042,6 +3454,84 @@ bool MaximumMatcher::FindArgumentPathDFS(int v, std::vector<bool>* visited) {
 
 }  // namespace
 
+bool MessageDifferencer::CanFingerprintElements(
+    const MapKeyComparator* key_comparator) const {
+  // Custom comparators and ignore criteria may equate any two values, and
+  // PARTIAL scope lets the second element have extra fields.
+  return key_comparator == nullptr && scope_ == FULL &&
+         field_comparator_kind_ == kFCDefault && ignore_criteria_.empty();
+}
+
+uint64_t MessageDifferencer::FingerprintMessage(const Message& message) const {
+  const Descriptor* descriptor = message.GetDescriptor();
+  // Any payloads are compared unpacked, so equal ones may differ in bytes.
+  if (descriptor->full_name() == internal::kAnyFullTypeName) return 0;
+  const Reflection* reflection = message.GetReflection();
+  uint64_t fingerprint = 0;
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const FieldDescriptor* field = descriptor->field(i);
+    if (field->is_map() || ignored_fields_.contains(field)) continue;
+    uint64_t value = 0;
+    if (field->is_repeated()) {
+      const int size = reflection->FieldSize(message, field);
+      for (int j = 0; j < size; ++j) {
+        value += FingerprintValue(message, field, j);
+      }
+    } else {
+      value = FingerprintValue(message, field, -1);
+    }
+    if (value != 0) {
+      fingerprint = absl::HashOf(fingerprint, field->number(), value);
+    }
+  }
+  return fingerprint;
+}
+
+uint64_t MessageDifferencer::FingerprintValue(const Message& message,
+                                              const FieldDescriptor* field,
+                                              int index) const {
+  const Reflection* reflection = message.GetReflection();
+  const bool repeated = index >= 0;
+  switch (field->cpp_type()) {
+#define HANDLE_TYPE(CPPTYPE, METHOD, DEFAULT)                             \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE: {                              \
+    const auto value =                                                    \
+        repeated ? reflection->GetRepeated##METHOD(message, field, index) \
+                 : reflection->Get##METHOD(message, field);               \
+    if (!repeated && value == DEFAULT) return 0;                          \
+    return absl::HashOf(value);                                           \
+  }
+    HANDLE_TYPE(INT32, Int32, field->default_value_int32());
+    HANDLE_TYPE(INT64, Int64, field->default_value_int64());
+    HANDLE_TYPE(UINT32, UInt32, field->default_value_uint32());
+    HANDLE_TYPE(UINT64, UInt64, field->default_value_uint64());
+    HANDLE_TYPE(BOOL, Bool, field->default_value_bool());
+    HANDLE_TYPE(ENUM, EnumValue, field->default_value_enum()->number());
+#undef HANDLE_TYPE
+    case FieldDescriptor::CPPTYPE_FLOAT:
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      // Compared with a margin or with NaN handling, so the bits mean little.
+      return repeated ? 1 : 0;
+    case FieldDescriptor::CPPTYPE_STRING: {
+      std::string scratch;
+      const std::string& value =
+          repeated ? reflection->GetRepeatedStringReference(message, field,
+                                                            index, &scratch)
+                   : reflection->GetStringReference(message, field, &scratch);
+      if (!repeated && value == field->default_value_string()) return 0;
+      return absl::HashOf(value);
+    }
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      if (repeated) {
+        return FingerprintMessage(
+            reflection->GetRepeatedMessage(message, field, index));
+      }
+      if (!reflection->HasField(message, field)) return 0;
+      return FingerprintMessage(reflection->GetMessage(message, field));
+  }
+  return 0;
+}
+
 bool MessageDifferencer::MatchRepeatedFieldIndices(
     const Message& message1, const Message& message2, int unpacked_any,
     const FieldDescriptor* repeated_field,
@@ -3105,52 +3595,94 @@ bool MessageDifferencer::MatchRepeatedFieldIndices(
         }
       }
     }
+    // Elements that compare equal have equal fingerprints, so an exact match
+    // for an element can only be among the elements in its bucket. Each
+    // bucket lists its indices in increasing order, which keeps the result
+    // the same as scanning all elements.
+    absl::flat_hash_map<uint64_t, std::vector<int>> buckets;
+    const bool use_buckets = count1 - start_offset > 1 &&
+                             count2 - start_offset > 1 &&
+                             CanFingerprintElements(key_comparator);
+    if (use_buckets) {
+      for (int j = start_offset; j < count2; ++j) {
+        buckets[FingerprintValue(message2, repeated_field, j)].push_back(j);
+      }
+    }
     for (int i = start_offset; i < count1; ++i) {
       // Indicates any matched elements for this repeated field.
       bool match = false;
       int matched_j = -1;
 
-      for (int j = start_offset; j < count2; j++) {
-        if (match_list2->at(j) != -1) {
-          if (!is_treated_as_smart_set || num_diffs_list1[i] == 0 ||
-              num_diffs_list1[match_list2->at(j)] == 0) {
-            continue;
+      if (use_buckets) {
+        auto bucket =
+            buckets.find(FingerprintValue(message1, repeated_field, i));
+        if (bucket != buckets.end()) {
+          for (int j : bucket->second) {
+            if (match_list2->at(j) != -1 &&
+                (!is_treated_as_smart_set ||
+                 num_diffs_list1[match_list2->at(j)] == 0)) {
+              continue;
+            }
+            num_diffs_reporter.Reset();
+            if (IsMatch(repeated_field, key_comparator, &message1, &message2,
+                        unpacked_any, parent_fields,
+                        is_treated_as_smart_set ? &num_diffs_reporter
+                                                : nullptr,
+                        i, j)) {
+              matched_j = j;
+              if (is_treated_as_smart_set) num_diffs_list1[i] = 0;
+              break;
+            }
           }
         }
+      }
 
-        if (is_treated_as_smart_set) {
-          num_diffs_reporter.Reset();
-          match =
-              IsMatch(repeated_field, key_comparator, &message1, &message2,
-                      unpacked_any, parent_fields, &num_diffs_reporter, i, j);
-        } else {
-          match = IsMatch(repeated_field, key_comparator, &message1, &message2,
-                          unpacked_any, parent_fields, nullptr, i, j);
-        }
+      // Without an exact match a smart set still pairs the element with the
+      // closest one, which needs the full scan.
+      if (matched_j == -1 && (!use_buckets || is_treated_as_smart_set)) {
+        for (int j = start_offset; j < count2; j++) {
+          if (match_list2->at(j) != -1) {
+            if (!is_treated_as_smart_set || num_diffs_list1[i] == 0 ||
+                num_diffs_list1[match_list2->at(j)] == 0) {
+              continue;
+            }
+          }
 
-        if (is_treated_as_smart_set) {
-          if (match) {
-            num_diffs_list1[i] = 0;
-          } else if (repeated_field->cpp_type() ==
-                     FieldDescriptor::CPPTYPE_MESSAGE) {
-            // Replace with the one with fewer diffs.
-            const int32_t num_diffs = num_diffs_reporter.GetNumDiffs();
-            if (num_diffs < num_diffs_list1[i]) {
-              // If j has been already matched to some element, ensure the
-              // current num_diffs is smaller.
-              if (match_list2->at(j) == -1 ||
-                  num_diffs < num_diffs_list1[match_list2->at(j)]) {
-                num_diffs_list1[i] = num_diffs;
-                match = true;
+          if (is_treated_as_smart_set) {
+            num_diffs_reporter.Reset();
+            match =
+                IsMatch(repeated_field, key_comparator, &message1, &message2,
+                        unpacked_any, parent_fields, &num_diffs_reporter, i, j);
+          } else {
+            match =
+                IsMatch(repeated_field, key_comparator, &message1, &message2,
+                        unpacked_any, parent_fields, nullptr, i, j);
+          }
+
+          if (is_treated_as_smart_set) {
+            if (match) {
+              num_diffs_list1[i] = 0;
+            } else if (repeated_field->cpp_type() ==
+                       FieldDescriptor::CPPTYPE_MESSAGE) {
+              // Replace with the one with fewer diffs.
+              const int32_t num_diffs = num_diffs_reporter.GetNumDiffs();
+              if (num_diffs < num_diffs_list1[i]) {
+                // If j has been already matched to some element, ensure the
+                // current num_diffs is smaller.
+                if (match_list2->at(j) == -1 ||
+                    num_diffs < num_diffs_list1[match_list2->at(j)]) {
+                  num_diffs_list1[i] = num_diffs;
+                  match = true;
+                }
               }
             }
           }
-        }
 
-        if (match) {
-          matched_j = j;
-          if (!is_treated_as_smart_set || num_diffs_list1[i] == 0) {
-            break;
+          if (match) {
+            matched_j = j;
+            if (!is_treated_as_smart_set || num_diffs_list1[i] == 0) {
+              break;
+            }
           }
         }
       }
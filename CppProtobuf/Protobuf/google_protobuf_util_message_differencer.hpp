@@ -1284,6 +1284,13 @@ class PROTOBUF_EXPORT MessageDifferencer {
   // if some fields should be ignored in the comparison. Use Compare() with
   // TreatAsSet() if there are repeated fields where ordering does not matter.
   //
+  // Messages with identical deterministic serializations are equal, so this
+  // method and the other static comparison methods below compare the
+  // serializations of generated messages first and only walk the fields if
+  // they differ. That check is skipped for types that may contain floating
+  // point values (a NaN is never equal to itself), Any messages or
+  // extensions.
+  //
   // This method REQUIRES that the two messages have the same
   // Descriptor (message1.GetDescriptor() == message2.GetDescriptor()).
   static bool Equals(const Message& message1, const Message& message2);
@@ -1597,13 +1604,15 @@ class PROTOBUF_EXPORT MessageDifferencer {
   // above, extra values added to repeated fields of the second message will
   // not cause the comparison to fail.
   //
-  // Note that set comparison is currently O(k * n^2) (where n is the total
-  // number of elements, and k is the average size of each element). In theory
-  // it could be made O(n * k) with a more complex hashing implementation. Feel
-  // free to contribute one if the current implementation is too slow for you.
-  // If partial matching is also enabled, the time complexity will be O(k * n^2
-  // + n^3) in which n^3 is the time complexity of the maximum matching
-  // algorithm.
+  // Set comparison buckets the elements by a structural fingerprint first, so
+  // that only elements with the same fingerprint are compared. This makes it
+  // O(n * k) (where n is the total number of elements, and k is the average
+  // size of each element) when most elements have an exact match. The
+  // fingerprint is only used with the default field comparator, no
+  // IgnoreCriteria and FULL scope. Otherwise, and for the elements of a smart
+  // set that have no exact match, comparison is O(k * n^2). If partial
+  // matching is also enabled, the time complexity will be O(k * n^2 + n^3) in
+  // which n^3 is the time complexity of the maximum matching algorithm.
   //
   // REQUIRES: field->is_repeated() and field not registered with TreatAsMap*
   void TreatAsSet(const FieldDescriptor* field);
@@ -1779,6 +1788,24 @@ class PROTOBUF_EXPORT MessageDifferencer {
   // Returns the current repeated field comparison used by this differencer.
   RepeatedFieldComparison repeated_field_comparison() const;
 
+  // If num_threads is greater than 1, Compare and CompareWithFields compare
+  // the top-level fields of the two messages as independent tasks on up to
+  // num_threads threads. Top-level repeated fields that are compared as lists
+  // and have at least 2 * min_chunk_elements elements are further split into
+  // chunks of min_chunk_elements elements; 0 disables chunking. Each task
+  // reports into a buffer of its own, and the buffers are replayed to the
+  // reporter in field and index order on the calling thread, so the result
+  // and the reported differences are identical to a serial comparison.
+  //
+  // Tasks run on private copies of this differencer's settings. Field
+  // comparators, map key comparators, ignore criteria and the smart list
+  // callback supplied by the caller are shared between the threads and must
+  // be thread-safe.
+  void set_parallel_comparison(int num_threads, int min_chunk_elements) {
+    parallel_threads_ = num_threads;
+    parallel_min_chunk_elements_ = min_chunk_elements;
+  }
+
   // Compares the two specified messages, returning true if they are the same,
   // false otherwise. If this method returns false, any changes between the
   // two messages will be reported if a Reporter was specified via
@@ -1925,6 +1952,10 @@ class PROTOBUF_EXPORT MessageDifferencer {
   // class is declared as a nested class of MessageDifferencer.
   class MultipleFieldsMapKeyComparator;
 
+  // A Reporter that records every report so that it can be replayed later.
+  // Used by the parallel comparison.
+  class BufferingReporter;
+
   // A MapKeyComparator for use with map_entries.
   class PROTOBUF_EXPORT MapEntryKeyComparator : public MapKeyComparator {
    public:
@@ -1982,6 +2013,18 @@ class PROTOBUF_EXPORT MessageDifferencer {
       const std::vector<const FieldDescriptor*>& message2_fields,
       std::vector<SpecificField>* parent_fields);
 
+  // Parallel version of CompareWithFieldsInternal for top-level messages. See
+  // set_parallel_comparison.
+  bool CompareFieldsInParallel(
+      const Message& message1, const Message& message2, int unpacked_any,
+      const std::vector<const FieldDescriptor*>& message1_fields,
+      const std::vector<const FieldDescriptor*>& message2_fields);
+
+  // Copies the comparison settings of other into this differencer, so that it
+  // can run tasks of a parallel comparison on another thread. Map key
+  // comparators created by other are recreated against this differencer.
+  void CopySettingsFrom(const MessageDifferencer& other);
+
   // Compares the repeated fields, and report the error.
   bool CompareRepeatedField(const Message& message1, const Message& message2,
                             int unpacked_any, const FieldDescriptor* field,
@@ -1999,6 +2042,15 @@ class PROTOBUF_EXPORT MessageDifferencer {
                           int unpacked_any, const FieldDescriptor* field,
                           std::vector<SpecificField>* parent_fields);
 
+  // Helper for CompareRepeatedRep: compares and reports the elements in
+  // [begin, end) of a repeated field that is compared as a simple list.
+  // Indices past the end of one of the fields are reported as added or
+  // deleted.
+  bool CompareListRange(const Message& message1, const Message& message2,
+                        int unpacked_any, const FieldDescriptor* field,
+                        int begin, int end,
+                        std::vector<SpecificField>* parent_fields);
+
   // Helper for CompareMapField: compare the map fields using map reflection
   // instead of sync to repeated.
   bool CompareMapFieldByMapReflection(const Message& message1,
@@ -2092,6 +2144,20 @@ class PROTOBUF_EXPORT MessageDifferencer {
       const std::vector<SpecificField>& parent_fields,
       std::vector<int>* match_list1, std::vector<int>* match_list2);
 
+  // Returns true if elements that Compare() equal are guaranteed to have equal
+  // fingerprints under the current settings, so that
+  // MatchRepeatedFieldIndices() may bucket elements by fingerprint.
+  bool CanFingerprintElements(const MapKeyComparator* key_comparator) const;
+
+  // Structural fingerprints of messages and field values. Everything the
+  // comparison may treat loosely is left out: presence, default values,
+  // floating point values, ignored fields, extensions, unknown fields, map
+  // fields and the payload of Any. Repeated fields are summed so that they
+  // fingerprint the same in any order. index is -1 for singular fields.
+  uint64_t FingerprintMessage(const Message& message) const;
+  uint64_t FingerprintValue(const Message& message,
+                            const FieldDescriptor* field, int index) const;
+
   // Checks if index is equal to new_index in all the specific fields.
   static bool CheckPathChanged(const std::vector<SpecificField>& parent_fields);
 
@@ -2121,7 +2187,8 @@ class PROTOBUF_EXPORT MessageDifferencer {
   absl::flat_hash_map<const FieldDescriptor*, const MapKeyComparator*>
       map_field_key_comparator_;
   MapEntryKeyComparator map_entry_key_comparator_;
-  std::vector<std::unique_ptr<IgnoreCriteria>> ignore_criteria_;
+  // Shared with the differencers that run a parallel comparison.
+  std::vector<std::shared_ptr<IgnoreCriteria>> ignore_criteria_;
   // Reused multiple times in RetrieveFields to avoid extra allocations
   std::vector<const FieldDescriptor*> tmp_message_fields_;
 
@@ -2145,6 +2212,15 @@ class PROTOBUF_EXPORT MessageDifferencer {
       match_indices_for_smart_list_callback_;
 
   MessageDifferencer::UnpackAnyField unpack_any_field_;
+
+  int parallel_threads_ = 1;
+  int parallel_min_chunk_elements_ = 0;
+
+  // Set on the differencers that run the tasks of a parallel comparison. Their
+  // reports are replayed after the tasks finish, so the Any payloads they
+  // unpack are kept alive until then.
+  bool parallel_task_ = false;
+  std::vector<std::unique_ptr<Message>> unpacked_any_messages_;
 };
 
 // This class provides extra information to the FieldComparator::Compare
@@ -0,0 +1,309 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google_protobuf_util_message_hash.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <CppAbseil/absl_numeric_int128.hpp>
+#include <CppAbseil/absl_strings_string_view.hpp>
+#include "google_protobuf_any.hpp"
+#include "google_protobuf_descriptor.hpp"
+#include "google_protobuf_dynamic_message.hpp"
+#include "google_protobuf_map_field.hpp"
+#include "google_protobuf_message.hpp"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+namespace {
+
+// A multiply-and-fold hash state. Every input word goes into one lane for
+// 64-bit hashes and into two lanes with different seeds and multipliers for
+// 128-bit hashes.
+template <bool kWide>
+class HashState {
+ public:
+  void Add(uint64_t value) {
+    lo_ = Mix(lo_ ^ value, kMul0);
+    if (kWide) hi_ = Mix(hi_ ^ value, kMul1);
+  }
+
+  void AddBytes(absl::string_view bytes) {
+    Add(bytes.size());
+    const char* p = bytes.data();
+    size_t n = bytes.size();
+    for (; n >= 8; p += 8, n -= 8) {
+      uint64_t word;
+      std::memcpy(&word, p, 8);
+      Add(word);
+    }
+    if (n > 0) {
+      uint64_t word = 0;
+      std::memcpy(&word, p, n);
+      Add(word);
+    }
+  }
+
+  void AddState(const HashState& other) {
+    Add(other.lo_);
+    if (kWide) Add(other.hi_);
+  }
+
+  uint64_t lo() const { return Mix(lo_, kMul1); }
+  uint64_t hi() const { return Mix(hi_, kMul0); }
+
+ private:
+  static constexpr uint64_t kMul0 = 0x9e3779b97f4a7c15;
+  static constexpr uint64_t kMul1 = 0xc2b2ae3d27d4eb4f;
+
+  static uint64_t Mix(uint64_t value, uint64_t multiplier) {
+    absl::uint128 product = absl::uint128(value) * multiplier;
+    return absl::Uint128High64(product) ^ absl::Uint128Low64(product);
+  }
+
+  uint64_t lo_ = 0x243f6a8885a308d3;
+  uint64_t hi_ = 0x13198a2e03707344;
+};
+
+template <typename T>
+uint64_t FloatBits(T value) {
+  // -0.0 == 0.0, so they have to hash the same.
+  if (value == 0) value = 0;
+  typename std::conditional<sizeof(T) == 8, uint64_t, uint32_t>::type bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+template <bool kWide>
+class MessageHasher {
+ public:
+  using State = HashState<kWide>;
+
+  // Adds the fields of message that do not have their default values to
+  // state. Returns false if there are none, so that the message hashes like
+  // an unset one.
+  bool HashMessage(const Message& message, State* state) {
+    const Descriptor* descriptor = message.GetDescriptor();
+    if (descriptor->full_name() == internal::kAnyFullTypeName &&
+        HashAny(message, state)) {
+      return true;
+    }
+
+    const Reflection* reflection = message.GetReflection();
+    // ListFields allocates, so the field lists are reused per nesting level.
+    // A deque keeps the outer levels' lists in place as nested calls add
+    // levels.
+    if (depth_ == fields_.size()) fields_.emplace_back();
+    std::vector<const FieldDescriptor*>& fields = fields_[depth_++];
+    reflection->ListFields(message, &fields);
+
+    bool hashed = false;
+    for (const FieldDescriptor* field : fields) {
+      if (field->is_map()) {
+        HashMap(message, field, state);
+        hashed = true;
+      } else if (field->is_repeated()) {
+        const int size = reflection->FieldSize(message, field);
+        state->Add(field->number());
+        state->Add(size);
+        for (int i = 0; i < size; ++i) {
+          HashValue(message, reflection, field, i, state);
+        }
+        hashed = true;
+      } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+        State sub_state;
+        if (HashMessage(reflection->GetMessage(message, field), &sub_state)) {
+          state->Add(field->number());
+          state->AddState(sub_state);
+          hashed = true;
+        }
+      } else if (!HasDefaultValue(message, reflection, field)) {
+        state->Add(field->number());
+        HashValue(message, reflection, field, -1, state);
+        hashed = true;
+      }
+    }
+    --depth_;
+    return hashed;
+  }
+
+ private:
+  // Hashes the payload of an Any together with its type, as
+  // MessageDifferencer compares unpacked payloads. Returns false if the
+  // payload cannot be unpacked, in which case the Any is hashed as is.
+  bool HashAny(const Message& any, State* state) {
+    const FieldDescriptor* type_url_field;
+    const FieldDescriptor* value_field;
+    if (!internal::GetAnyFieldDescriptors(any, &type_url_field,
+                                          &value_field)) {
+      return false;
+    }
+    const Reflection* reflection = any.GetReflection();
+    std::string full_type_name;
+    if (!internal::ParseAnyTypeUrl(reflection->GetString(any, type_url_field),
+                                   &full_type_name)) {
+      return false;
+    }
+    const Descriptor* descriptor =
+        any.GetDescriptor()->file()->pool()->FindMessageTypeByName(
+            full_type_name);
+    if (descriptor == nullptr) {
+      return false;
+    }
+    const Message* prototype =
+        MessageFactory::generated_factory()->GetPrototype(descriptor);
+    if (prototype == nullptr) {
+      if (dynamic_factory_ == nullptr) {
+        dynamic_factory_ = std::make_unique<DynamicMessageFactory>();
+      }
+      prototype = dynamic_factory_->GetPrototype(descriptor);
+    }
+    std::unique_ptr<Message> payload(prototype->New());
+    if (!payload->ParsePartialFromString(
+            reflection->GetString(any, value_field))) {
+      return false;
+    }
+    // Payloads only compare equal to payloads of the same type.
+    state->AddBytes(full_type_name);
+    State payload_state;
+    HashMessage(*payload, &payload_state);
+    state->AddState(payload_state);
+    return true;
+  }
+
+  // Map entries are matched by key, so their hashes are summed.
+  void HashMap(const Message& message, const FieldDescriptor* field,
+               State* state) {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+    internal::MapEntryReader entries(message, field, /*sorted=*/false);
+    while (const Message* entry = entries.Next()) {
+      State entry_state;
+      HashMessage(*entry, &entry_state);
+      lo += entry_state.lo();
+      if (kWide) hi += entry_state.hi();
+    }
+    state->Add(field->number());
+    state->Add(entries.size());
+    state->Add(lo);
+    if (kWide) state->Add(hi);
+  }
+
+  static bool HasDefaultValue(const Message& message,
+                              const Reflection* reflection,
+                              const FieldDescriptor* field) {
+    switch (field->cpp_type()) {
+      case FieldDescriptor::CPPTYPE_INT32:
+        return reflection->GetInt32(message, field) ==
+               field->default_value_int32();
+      case FieldDescriptor::CPPTYPE_INT64:
+        return reflection->GetInt64(message, field) ==
+               field->default_value_int64();
+      case FieldDescriptor::CPPTYPE_UINT32:
+        return reflection->GetUInt32(message, field) ==
+               field->default_value_uint32();
+      case FieldDescriptor::CPPTYPE_UINT64:
+        return reflection->GetUInt64(message, field) ==
+               field->default_value_uint64();
+      case FieldDescriptor::CPPTYPE_DOUBLE:
+        return reflection->GetDouble(message, field) ==
+               field->default_value_double();
+      case FieldDescriptor::CPPTYPE_FLOAT:
+        return reflection->GetFloat(message, field) ==
+               field->default_value_float();
+      case FieldDescriptor::CPPTYPE_BOOL:
+        return reflection->GetBool(message, field) ==
+               field->default_value_bool();
+      case FieldDescriptor::CPPTYPE_ENUM:
+        return reflection->GetEnumValue(message, field) ==
+               field->default_value_enum()->number();
+      case FieldDescriptor::CPPTYPE_STRING: {
+        std::string scratch;
+        return reflection->GetStringReference(message, field, &scratch) ==
+               field->default_value_string();
+      }
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        break;
+    }
+    return false;
+  }
+
+  // Hashes the value of a singular field, or the element at index of a
+  // repeated one (index is -1 for singular fields).
+  void HashValue(const Message& message, const Reflection* reflection,
+                 const FieldDescriptor* field, int index, State* state) {
+    const bool repeated = index >= 0;
+    switch (field->cpp_type()) {
+#define HANDLE_TYPE(CPPTYPE, METHOD, CONVERT)                                  \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                                     \
+    state->Add(CONVERT(repeated                                                \
+                           ? reflection->GetRepeated##METHOD(message, field,   \
+                                                             index)            \
+                           : reflection->Get##METHOD(message, field)));        \
+    break;
+#define AS_IS(value) static_cast<uint64_t>(value)
+      HANDLE_TYPE(INT32, Int32, AS_IS)
+      HANDLE_TYPE(INT64, Int64, AS_IS)
+      HANDLE_TYPE(UINT32, UInt32, AS_IS)
+      HANDLE_TYPE(UINT64, UInt64, AS_IS)
+      HANDLE_TYPE(BOOL, Bool, AS_IS)
+      HANDLE_TYPE(ENUM, EnumValue, AS_IS)
+      HANDLE_TYPE(DOUBLE, Double, FloatBits)
+      HANDLE_TYPE(FLOAT, Float, FloatBits)
+#undef AS_IS
+#undef HANDLE_TYPE
+      case FieldDescriptor::CPPTYPE_STRING: {
+        std::string scratch;
+        state->AddBytes(
+            repeated ? reflection->GetRepeatedStringReference(message, field,
+                                                              index, &scratch)
+                     : reflection->GetStringReference(message, field,
+                                                      &scratch));
+        break;
+      }
+      case FieldDescriptor::CPPTYPE_MESSAGE: {
+        State sub_state;
+        HashMessage(repeated
+                        ? reflection->GetRepeatedMessage(message, field, index)
+                        : reflection->GetMessage(message, field),
+                    &sub_state);
+        state->AddState(sub_state);
+        break;
+      }
+    }
+  }
+
+  std::deque<std::vector<const FieldDescriptor*>> fields_;
+  size_t depth_ = 0;
+  std::unique_ptr<DynamicMessageFactory> dynamic_factory_;
+};
+
+}  // namespace
+
+uint64_t MessageHash::Hash64(const Message& message) {
+  HashState<false> state;
+  MessageHasher<false>().HashMessage(message, &state);
+  return state.lo();
+}
+
+absl::uint128 MessageHash::Hash128(const Message& message) {
+  HashState<true> state;
+  MessageHasher<true>().HashMessage(message, &state);
+  return absl::MakeUint128(state.hi(), state.lo());
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
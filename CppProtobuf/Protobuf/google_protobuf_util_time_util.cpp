@@ -9,6 +9,7 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
 #include "google_protobuf_duration.pb.hpp"
 #include "google_protobuf_timestamp.pb.hpp"
@@ -1221,6 +1222,7 @@ static constexpr int32_t kNanosPerMicrosecond = 1000;
 static constexpr int32_t kSecondsPerMinute =
     60;  // Note that we ignore leap seconds.
 static constexpr int32_t kSecondsPerHour = 3600;
+static constexpr int32_t kSecondsPerDay = 86400;
 
 template <typename T>
 T CreateNormalized(int64_t seconds, int32_t nanos);
@@ -1348,6 +1350,173 @@ int64_t RoundTowardZero(int64_t value, int64_t divider) {
     return result;
   }
 }
+
+// "00", "01", ..., "99", for writing two digits at a time.
+struct DigitPairs {
+  constexpr DigitPairs() : chars() {
+    for (int i = 0; i < 100; ++i) {
+      chars[2 * i] = static_cast<char>('0' + i / 10);
+      chars[2 * i + 1] = static_cast<char>('0' + i % 10);
+    }
+  }
+  char chars[200];
+};
+constexpr DigitPairs kDigitPairs;
+
+char* WriteTwoDigits(int value, char* out) {
+  std::memcpy(out, &kDigitPairs.chars[2 * value], 2);
+  return out + 2;
+}
+
+char* WriteUnsigned(uint64_t value, char* out) {
+  char digits[20];
+  char* start = digits + sizeof(digits);
+  while (value >= 100) {
+    start -= 2;
+    WriteTwoDigits(static_cast<int>(value % 100), start);
+    value /= 100;
+  }
+  if (value >= 10) {
+    start -= 2;
+    WriteTwoDigits(static_cast<int>(value), start);
+  } else {
+    *--start = static_cast<char>('0' + value);
+  }
+  const size_t length = digits + sizeof(digits) - start;
+  std::memcpy(out, start, length);
+  return out + length;
+}
+
+// Writes a '.' and 3, 6 or 9 digits, like FormatNanos().
+char* WriteNanos(int32_t nanos, char* out) {
+  int digits = 9;
+  if (nanos % kNanosPerMillisecond == 0) {
+    nanos /= kNanosPerMillisecond;
+    digits = 3;
+  } else if (nanos % kNanosPerMicrosecond == 0) {
+    nanos /= kNanosPerMicrosecond;
+    digits = 6;
+  }
+  *out++ = '.';
+  for (int i = digits - 1; i >= 0; --i) {
+    out[i] = static_cast<char>('0' + nanos % 10);
+    nanos /= 10;
+  }
+  return out + digits;
+}
+
+// Conversions between days since 1970-01-01 and dates in the proleptic
+// Gregorian calendar, counting in 400-year eras of 146097 days each.
+// See http://howardhinnant.github.io/date_algorithms.html.
+void CivilFromDays(int64_t days, int* year, int* month, int* day) {
+  days += 719468;  // Shift the epoch to 0000-03-01.
+  const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+  const int64_t day_of_era = days - era * 146097;
+  const int64_t year_of_era =
+      (day_of_era - day_of_era / 1460 + day_of_era / 36524 -
+       day_of_era / 146096) /
+      365;
+  const int64_t day_of_year =
+      day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  const int64_t shifted_month = (5 * day_of_year + 2) / 153;  // March is 0.
+  *day = static_cast<int>(day_of_year - (153 * shifted_month + 2) / 5 + 1);
+  *month = static_cast<int>(shifted_month < 10 ? shifted_month + 3
+                                               : shifted_month - 9);
+  *year = static_cast<int>(year_of_era + era * 400 + (*month <= 2 ? 1 : 0));
+}
+
+int64_t DaysFromCivil(int year, int month, int day) {
+  const int64_t shifted_year = year - (month <= 2 ? 1 : 0);
+  const int64_t era =
+      (shifted_year >= 0 ? shifted_year : shifted_year - 399) / 400;
+  const int64_t year_of_era = shifted_year - era * 400;
+  const int64_t day_of_year =
+      (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const int64_t day_of_era =
+      year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  return era * 146097 + day_of_era - 719468;
+}
+
+int DaysInMonth(int year, int month) {
+  static constexpr int kDays[] = {31, 28, 31, 30, 31, 30,
+                                  31, 31, 30, 31, 30, 31};
+  if (month == 2 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) {
+    return 29;
+  }
+  return kDays[month - 1];
+}
+
+// Reads 'count' decimal digits at 'p'.
+bool ParseDigits(const char* p, int count, int* value) {
+  int result = 0;
+  for (int i = 0; i < count; ++i) {
+    if (p[i] < '0' || p[i] > '9') return false;
+    result = result * 10 + (p[i] - '0');
+  }
+  *value = result;
+  return true;
+}
+
+// Parses the common form "YYYY-MM-DDTHH:MM:SS[.F](Z|+HH:MM|-HH:MM)", with 1
+// to 9 fractional digits, without allocating. Returns false if the value has
+// any other form, some of which ParseTime() still accepts.
+bool ParseTimeFast(absl::string_view value, int64_t* seconds, int32_t* nanos) {
+  const char* p = value.data();
+  const size_t size = value.size();
+  int year, month, day, hour, minute, second;
+  if (size < 20 || p[4] != '-' || p[7] != '-' || p[10] != 'T' ||
+      p[13] != ':' || p[16] != ':' || !ParseDigits(p, 4, &year) ||
+      !ParseDigits(p + 5, 2, &month) || !ParseDigits(p + 8, 2, &day) ||
+      !ParseDigits(p + 11, 2, &hour) || !ParseDigits(p + 14, 2, &minute) ||
+      !ParseDigits(p + 17, 2, &second)) {
+    return false;
+  }
+  // Leap seconds are left to ParseTime().
+  if (year < 1 || month < 1 || month > 12 || day < 1 ||
+      day > DaysInMonth(year, month) || hour > 23 || minute > 59 ||
+      second > 59) {
+    return false;
+  }
+
+  size_t pos = 19;
+  int32_t fraction = 0;
+  if (p[pos] == '.') {
+    const size_t begin = ++pos;
+    while (pos < size && pos - begin < 9 && p[pos] >= '0' && p[pos] <= '9') {
+      fraction = fraction * 10 + (p[pos++] - '0');
+    }
+    const size_t digits = pos - begin;
+    // Longer fractions are truncated by ParseTime().
+    if (digits == 0 || pos == size || (p[pos] >= '0' && p[pos] <= '9')) {
+      return false;
+    }
+    for (size_t i = digits; i < 9; ++i) fraction *= 10;
+  }
+
+  int offset = 0;
+  if (p[pos] == 'Z') {
+    ++pos;
+  } else if (p[pos] == '+' || p[pos] == '-') {
+    int offset_hours, offset_minutes;
+    if (size - pos != 6 || p[pos + 3] != ':' ||
+        !ParseDigits(p + pos + 1, 2, &offset_hours) ||
+        !ParseDigits(p + pos + 4, 2, &offset_minutes) || offset_hours > 23 ||
+        offset_minutes > 59) {
+      return false;
+    }
+    offset =
+        offset_hours * kSecondsPerHour + offset_minutes * kSecondsPerMinute;
+    if (p[pos] == '-') offset = -offset;
+    pos += 6;
+  }
+  if (pos != size) return false;
+
+  *seconds = DaysFromCivil(year, month, day) * kSecondsPerDay +
+             hour * kSecondsPerHour + minute * kSecondsPerMinute + second -
+             offset;
+  *nanos = fraction;
+  return true;
+}
 }  // namespace
 
 // Actually define these static const integers. Required by C++ standard (but
@@ -1361,16 +1530,59 @@ constexpr int64_t TimeUtil::kDurationMaxSeconds;
 constexpr int64_t TimeUtil::kDurationMinSeconds;
 constexpr int32_t TimeUtil::kDurationMaxNanoseconds;
 constexpr int32_t TimeUtil::kDurationMinNanoseconds;
+constexpr size_t TimeUtil::kMaxTimestampStringLength;
+constexpr size_t TimeUtil::kMaxDurationStringLength;
 #endif  // !_MSC_VER
 
 std::string TimeUtil::ToString(const Timestamp& timestamp) {
-  return FormatTime(timestamp.seconds(), timestamp.nanos());
+  if (!IsTimestampValid(timestamp)) {
+    return FormatTime(timestamp.seconds(), timestamp.nanos());
+  }
+  char buffer[kMaxTimestampStringLength];
+  return std::string(buffer, ToString(timestamp, buffer));
+}
+
+size_t TimeUtil::ToString(const Timestamp& timestamp, char* buffer) {
+  ABSL_DCHECK(IsTimestampValid(timestamp))
+      << "Timestamp is outside of the valid range";
+  const int64_t seconds = timestamp.seconds();
+  int64_t days = seconds / kSecondsPerDay;
+  int64_t second_of_day = seconds % kSecondsPerDay;
+  if (second_of_day < 0) {
+    --days;
+    second_of_day += kSecondsPerDay;
+  }
+  int year, month, day;
+  CivilFromDays(days, &year, &month, &day);
+
+  char* out = buffer;
+  out = WriteTwoDigits(year / 100, out);
+  out = WriteTwoDigits(year % 100, out);
+  *out++ = '-';
+  out = WriteTwoDigits(month, out);
+  *out++ = '-';
+  out = WriteTwoDigits(day, out);
+  *out++ = 'T';
+  out = WriteTwoDigits(static_cast<int>(second_of_day / kSecondsPerHour), out);
+  *out++ = ':';
+  out = WriteTwoDigits(
+      static_cast<int>(second_of_day % kSecondsPerHour / kSecondsPerMinute),
+      out);
+  *out++ = ':';
+  out = WriteTwoDigits(static_cast<int>(second_of_day % kSecondsPerMinute),
+                       out);
+  if (timestamp.nanos() != 0) {
+    out = WriteNanos(timestamp.nanos(), out);
+  }
+  *out++ = 'Z';
+  return out - buffer;
 }
 
 bool TimeUtil::FromString(absl::string_view value, Timestamp* timestamp) {
   int64_t seconds;
   int32_t nanos;
-  if (!ParseTime(value, &seconds, &nanos)) {
+  if (!ParseTimeFast(value, &seconds, &nanos) &&
+      !ParseTime(value, &seconds, &nanos)) {
     return false;
   }
   *timestamp = CreateNormalized<Timestamp>(seconds, nanos);
@@ -1387,6 +1599,10 @@ Timestamp TimeUtil::GetCurrentTime() {
 Timestamp TimeUtil::GetEpoch() { return Timestamp(); }
 
 std::string TimeUtil::ToString(const Duration& duration) {
+  if (IsDurationValid(duration)) {
+    char buffer[kMaxDurationStringLength];
+    return std::string(buffer, ToString(duration, buffer));
+  }
   std::string result;
   int64_t seconds = duration.seconds();
   int32_t nanos = duration.nanos();
@@ -1403,6 +1619,25 @@ std::string TimeUtil::ToString(const Duration& duration) {
   return result;
 }
 
+size_t TimeUtil::ToString(const Duration& duration, char* buffer) {
+  ABSL_DCHECK(IsDurationValid(duration))
+      << "Duration is outside of the valid range";
+  int64_t seconds = duration.seconds();
+  int32_t nanos = duration.nanos();
+  char* out = buffer;
+  if (seconds < 0 || nanos < 0) {
+    *out++ = '-';
+    seconds = -seconds;
+    nanos = -nanos;
+  }
+  out = WriteUnsigned(static_cast<uint64_t>(seconds), out);
+  if (nanos != 0) {
+    out = WriteNanos(nanos, out);
+  }
+  *out++ = 's';
+  return out - buffer;
+}
+
 static int64_t Pow(int64_t x, int y) {
   int64_t result = 1;
   for (int i = 0; i < y; ++i) {
@@ -10,6 +10,7 @@
 #ifndef GOOGLE_PROTOBUF_UTIL_TIME_UTIL_H__
 #define GOOGLE_PROTOBUF_UTIL_TIME_UTIL_H__
 
+#include <cstddef>
 #include <cstdint>
 #include <ctime>
 #include <ostream>
@@ -1272,6 +1273,16 @@ class PROTOBUF_EXPORT TimeUtil {
   static std::string ToString(const Timestamp& timestamp);
   static bool FromString(absl::string_view value, Timestamp* timestamp);
 
+  // The longest strings ToString() returns for valid Timestamps and Durations.
+  static constexpr size_t kMaxTimestampStringLength = 30;
+  static constexpr size_t kMaxDurationStringLength = 24;
+
+  // Writes the string ToString() would return to 'buffer' without allocating,
+  // and returns its length. 'buffer' must have room for
+  // kMaxTimestampStringLength characters. No terminating null character is
+  // written. The Timestamp must be valid.
+  static size_t ToString(const Timestamp& timestamp, char* buffer);
+
   // Converts Duration to/from string format. The string format will contains
   // 3, 6, or 9 fractional digits depending on the precision required to
   // represent the exact Duration value. For example:
@@ -1281,6 +1292,10 @@ class PROTOBUF_EXPORT TimeUtil {
   static std::string ToString(const Duration& duration);
   static bool FromString(absl::string_view value, Duration* duration);
 
+  // Like ToString(const Timestamp&, char*), but for a valid Duration and a
+  // buffer of kMaxDurationStringLength characters.
+  static size_t ToString(const Duration& duration, char* buffer);
+
   // Gets the current UTC time.
   static Timestamp GetCurrentTime();
   // Returns the Time representing "1970-01-01 00:00:00".
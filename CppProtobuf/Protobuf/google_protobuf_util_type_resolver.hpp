@@ -1205,7 +1205,11 @@ PROTOBUF_EXPORT void protobuf_assumption_failed(const char *pred,
 namespace google {
 namespace protobuf {
 class DescriptorPool;
+namespace json_internal {
+class ResolverPool;
+}  // namespace json_internal
 namespace util {
+class CachingTypeResolver;
 
 // Abstract interface for a type resolver.
 //
@@ -1224,6 +1228,13 @@ class PROTOBUF_EXPORT TypeResolver {
   // Resolves a type url for an enum type.
   virtual absl::Status ResolveEnumType(const std::string& type_url,
                                        google::protobuf::Enum* enum_type) = 0;
+
+ private:
+  friend class json_internal::ResolverPool;
+
+  // Lets JSON conversion share the types cached by a CachingTypeResolver
+  // instead of copying them.
+  virtual CachingTypeResolver* AsCachingTypeResolver() { return nullptr; }
 };
 
 }  // namespace util
@@ -7,7 +7,10 @@
 
 #include "google_protobuf_util_type_resolver_util.hpp"
 
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "google_protobuf_source_context.pb.hpp"
@@ -16,10 +19,12 @@
 #include "google_protobuf_descriptor.pb.hpp"
 #include <CppAbseil/absl_log_absl_log.hpp>
 #include <CppAbseil/absl_status_status.hpp>
+#include <CppAbseil/absl_status_statusor.hpp>
 #include <CppAbseil/absl_strings_escaping.hpp>
 #include <CppAbseil/absl_strings_str_cat.hpp>
 #include <CppAbseil/absl_strings_string_view.hpp>
 #include <CppAbseil/absl_strings_strip.hpp>
+#include <CppAbseil/absl_synchronization_mutex.hpp>
 #include "google_protobuf_descriptor_legacy.hpp"
 #include "google_protobuf_io_strtod.hpp"
 #include "google_protobuf_util_type_resolver.hpp"
@@ -1542,6 +1547,112 @@ TypeResolver* NewTypeResolverForDescriptorPool(absl::string_view url_prefix,
   return new DescriptorPoolTypeResolver(url_prefix, pool);
 }
 
+template <typename T>
+std::shared_ptr<const T> CachingTypeResolver::LruMap<T>::Find(
+    absl::string_view type_url) {
+  auto it = index_.find(type_url);
+  if (it == index_.end()) {
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->second;
+}
+
+template <typename T>
+void CachingTypeResolver::LruMap<T>::Insert(const std::string& type_url,
+                                            std::shared_ptr<const T> value,
+                                            size_t max_size) {
+  // Another thread may have resolved the same type in the meantime.
+  if (index_.contains(type_url)) {
+    return;
+  }
+  entries_.emplace_front(type_url, std::move(value));
+  index_.try_emplace(entries_.front().first, entries_.begin());
+  while (entries_.size() > max_size) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+}
+
+CachingTypeResolver::CachingTypeResolver(TypeResolver* delegate,
+                                         size_t max_types)
+    : delegate_(delegate), max_types_(max_types) {}
+
+CachingTypeResolver::~CachingTypeResolver() = default;
+
+absl::Status CachingTypeResolver::ResolveMessageType(
+    const std::string& type_url, Type* message_type) {
+  absl::StatusOr<std::shared_ptr<const MessageType>> cached =
+      FindMessageType(type_url);
+  if (!cached.ok()) {
+    return cached.status();
+  }
+  *message_type = (*cached)->type;
+  return absl::Status();
+}
+
+absl::Status CachingTypeResolver::ResolveEnumType(const std::string& type_url,
+                                                  Enum* enum_type) {
+  absl::StatusOr<std::shared_ptr<const Enum>> cached = FindEnumType(type_url);
+  if (!cached.ok()) {
+    return cached.status();
+  }
+  *enum_type = **cached;
+  return absl::Status();
+}
+
+absl::StatusOr<std::shared_ptr<const CachingTypeResolver::MessageType>>
+CachingTypeResolver::FindMessageType(const std::string& type_url) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (std::shared_ptr<const MessageType> cached =
+            message_types_.Find(type_url)) {
+      return cached;
+    }
+  }
+
+  // Resolve without holding the lock, since the delegate may be slow.
+  auto resolved = std::make_shared<MessageType>();
+  absl::Status status =
+      delegate_->ResolveMessageType(type_url, &resolved->type);
+  if (!status.ok()) {
+    return status;
+  }
+  for (int i = 0; i < resolved->type.fields_size(); ++i) {
+    const Field& field = resolved->type.fields(i);
+    resolved->fields_by_name.try_emplace(field.name(), i);
+    resolved->fields_by_number.try_emplace(field.number(), i);
+  }
+  for (int i = 0; i < resolved->type.fields_size(); ++i) {
+    resolved->fields_by_name.try_emplace(resolved->type.fields(i).json_name(),
+                                         i);
+  }
+
+  absl::MutexLock lock(&mutex_);
+  message_types_.Insert(type_url, resolved, max_types_);
+  return resolved;
+}
+
+absl::StatusOr<std::shared_ptr<const Enum>> CachingTypeResolver::FindEnumType(
+    const std::string& type_url) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (std::shared_ptr<const Enum> cached = enum_types_.Find(type_url)) {
+      return cached;
+    }
+  }
+
+  auto resolved = std::make_shared<Enum>();
+  absl::Status status = delegate_->ResolveEnumType(type_url, resolved.get());
+  if (!status.ok()) {
+    return status;
+  }
+
+  absl::MutexLock lock(&mutex_);
+  enum_types_.Insert(type_url, resolved, max_types_);
+  return resolved;
+}
+
 // Performs a direct conversion from a descriptor to a type proto.
 Type ConvertDescriptorToType(absl::string_view url_prefix,
                              const Descriptor& descriptor) {
@@ -10,9 +10,21 @@
 #ifndef GOOGLE_PROTOBUF_UTIL_TYPE_RESOLVER_UTIL_H__
 #define GOOGLE_PROTOBUF_UTIL_TYPE_RESOLVER_UTIL_H__
 
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+
 #include <CppProtobuf/google_protobuf_type.pb.hpp>
+#include <CppAbseil/absl_container_flat_hash_map.hpp>
+#include <CppAbseil/absl_status_status.hpp>
+#include <CppAbseil/absl_status_statusor.hpp>
 #include <CppAbseil/absl_strings_string_view.hpp>
+#include <CppAbseil/absl_synchronization_mutex.hpp>
 #include <CppProtobuf/google_protobuf_descriptor.hpp>
+#include <CppProtobuf/google_protobuf_util_type_resolver.hpp>
 
 // Must be included last.
 
@@ -1203,13 +1215,81 @@ namespace google {
 namespace protobuf {
 class DescriptorPool;
 namespace util {
-class TypeResolver;
 
 // Creates a TypeResolver that serves type information in the given descriptor
 // pool. Caller takes ownership of the returned TypeResolver.
 PROTOBUF_EXPORT TypeResolver* NewTypeResolverForDescriptorPool(
     absl::string_view url_prefix, const DescriptorPool* pool);
 
+// A TypeResolver that keeps the types resolved by another TypeResolver, so
+// that converting many messages of the same few types resolves each type once.
+// Up to `max_types` message types and as many enum types are kept; beyond
+// that, the least recently used ones are dropped. Failed lookups are not
+// cached.
+//
+// Each cached message type comes with tables for looking up its fields by
+// name, JSON name and number. When a CachingTypeResolver is passed to the
+// JSON conversion functions, the cached types and tables are shared across
+// calls and threads rather than copied and rebuilt for each call.
+//
+// This class is thread-safe.
+class PROTOBUF_EXPORT CachingTypeResolver final : public TypeResolver {
+ public:
+  // A resolved message type with its field lookup tables, which map to
+  // indices into `type.fields()`.
+  struct MessageType {
+    google::protobuf::Type type;
+    // Both field names and JSON names; names win over JSON names.
+    absl::flat_hash_map<absl::string_view, int> fields_by_name;
+    absl::flat_hash_map<int32_t, int> fields_by_number;
+  };
+
+  // Does not take ownership of `delegate`, which must outlive this resolver.
+  CachingTypeResolver(TypeResolver* delegate, size_t max_types);
+  ~CachingTypeResolver() override;
+
+  absl::Status ResolveMessageType(
+      const std::string& type_url,
+      google::protobuf::Type* message_type) override;
+  absl::Status ResolveEnumType(const std::string& type_url,
+                               google::protobuf::Enum* enum_type) override;
+
+  // Like ResolveMessageType() and ResolveEnumType(), but return the cached
+  // types without copying them. The results stay valid after they are
+  // dropped from the cache.
+  absl::StatusOr<std::shared_ptr<const MessageType>> FindMessageType(
+      const std::string& type_url);
+  absl::StatusOr<std::shared_ptr<const google::protobuf::Enum>> FindEnumType(
+      const std::string& type_url);
+
+ private:
+  // A map from type URLs to values that remembers which entries were used
+  // least recently.
+  template <typename T>
+  class LruMap {
+   public:
+    std::shared_ptr<const T> Find(absl::string_view type_url);
+    void Insert(const std::string& type_url, std::shared_ptr<const T> value,
+                size_t max_size);
+
+   private:
+    using Entry = std::pair<std::string, std::shared_ptr<const T>>;
+
+    // Most recently used first.
+    std::list<Entry> entries_;
+    absl::flat_hash_map<absl::string_view, typename std::list<Entry>::iterator>
+        index_;
+  };
+
+  CachingTypeResolver* AsCachingTypeResolver() override { return this; }
+
+  TypeResolver* const delegate_;
+  const size_t max_types_;
+  absl::Mutex mutex_;
+  LruMap<MessageType> message_types_ ABSL_GUARDED_BY(mutex_);
+  LruMap<google::protobuf::Enum> enum_types_ ABSL_GUARDED_BY(mutex_);
+};
+
 // Performs a direct conversion from a descriptor to a type proto.
 PROTOBUF_EXPORT google::protobuf::Type ConvertDescriptorToType(
     absl::string_view url_prefix, const Descriptor& descriptor);
@@ -1986,6 +1986,196 @@ const char* WireFormat::_InternalParse(Message* msg, const char* ptr,
   return ptr;
 }
 
+// A map entry key or value as read from the wire: the bits of a scalar, or
+// the bytes of a string.
+struct MapEntryFieldValue {
+  uint64_t bits = 0;
+  std::string str;
+};
+
+// Parses the key or value of a map entry, which must be a scalar or a string.
+static const char* ParseMapEntryField(const FieldDescriptor* field,
+                                      const char* ptr, ParseContext* ctx,
+                                      MapEntryFieldValue* out) {
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_INT32:
+    case FieldDescriptor::TYPE_INT64:
+    case FieldDescriptor::TYPE_UINT32:
+    case FieldDescriptor::TYPE_UINT64:
+    case FieldDescriptor::TYPE_BOOL:
+    case FieldDescriptor::TYPE_ENUM:
+      return VarintParse(ptr, &out->bits);
+    case FieldDescriptor::TYPE_SINT32:
+      out->bits = static_cast<uint64_t>(ReadVarintZigZag32(&ptr));
+      return ptr;
+    case FieldDescriptor::TYPE_SINT64:
+      out->bits = static_cast<uint64_t>(ReadVarintZigZag64(&ptr));
+      return ptr;
+    case FieldDescriptor::TYPE_FIXED32:
+    case FieldDescriptor::TYPE_SFIXED32:
+    case FieldDescriptor::TYPE_FLOAT:
+      out->bits = UnalignedLoad<uint32_t>(ptr);
+      return ptr + sizeof(uint32_t);
+    case FieldDescriptor::TYPE_FIXED64:
+    case FieldDescriptor::TYPE_SFIXED64:
+    case FieldDescriptor::TYPE_DOUBLE:
+      out->bits = UnalignedLoad<uint64_t>(ptr);
+      return ptr + sizeof(uint64_t);
+    case FieldDescriptor::TYPE_STRING:
+    case FieldDescriptor::TYPE_BYTES: {
+      int size = ReadSize(&ptr);
+      if (ptr == nullptr) return nullptr;
+      ptr = ctx->ReadString(ptr, size, &out->str);
+      if (ptr == nullptr) return nullptr;
+      if (field->type() == FieldDescriptor::TYPE_STRING) {
+        if (field->requires_utf8_validation()) {
+          if (!WireFormatLite::VerifyUtf8String(
+                  out->str.data(), out->str.length(), WireFormatLite::PARSE,
+                  field->full_name().c_str())) {
+            return nullptr;
+          }
+        } else {
+          WireFormat::VerifyUTF8StringNamedField(
+              out->str.data(), out->str.length(), WireFormat::PARSE,
+              field->full_name().c_str());
+        }
+      }
+      return ptr;
+    }
+    case FieldDescriptor::TYPE_GROUP:
+    case FieldDescriptor::TYPE_MESSAGE:
+      break;
+  }
+  ABSL_LOG(FATAL) << "Can't reach";
+  return nullptr;
+}
+
+static void SetMapKeyFromWire(const FieldDescriptor* field,
+                              MapEntryFieldValue* in, MapKey* key) {
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      key->SetInt32Value(static_cast<int32_t>(in->bits));
+      return;
+    case FieldDescriptor::CPPTYPE_INT64:
+      key->SetInt64Value(static_cast<int64_t>(in->bits));
+      return;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      key->SetUInt32Value(static_cast<uint32_t>(in->bits));
+      return;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      key->SetUInt64Value(in->bits);
+      return;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      key->SetBoolValue(in->bits != 0);
+      return;
+    case FieldDescriptor::CPPTYPE_STRING:
+      key->SetStringValue(std::move(in->str));
+      return;
+    default:
+      ABSL_LOG(FATAL) << "Can't reach";
+  }
+}
+
+static void SetMapValueFromWire(const FieldDescriptor* field,
+                                const MapEntryFieldValue& in,
+                                MapValueRef* value) {
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      value->SetInt32Value(static_cast<int32_t>(in.bits));
+      return;
+    case FieldDescriptor::CPPTYPE_INT64:
+      value->SetInt64Value(static_cast<int64_t>(in.bits));
+      return;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      value->SetUInt32Value(static_cast<uint32_t>(in.bits));
+      return;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      value->SetUInt64Value(in.bits);
+      return;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      value->SetBoolValue(in.bits != 0);
+      return;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      value->SetEnumValue(static_cast<int>(in.bits));
+      return;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      value->SetFloatValue(
+          WireFormatLite::DecodeFloat(static_cast<uint32_t>(in.bits)));
+      return;
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      value->SetDoubleValue(WireFormatLite::DecodeDouble(in.bits));
+      return;
+    case FieldDescriptor::CPPTYPE_STRING:
+      value->SetStringValue(in.str);
+      return;
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      ABSL_LOG(FATAL) << "Can't reach";
+  }
+}
+
+const char* WireFormat::ParseMapEntries(Message* msg, const char* ptr,
+                                        internal::ParseContext* ctx,
+                                        uint32_t tag,
+                                        const Reflection* reflection,
+                                        const FieldDescriptor* field) {
+  const FieldDescriptor* key_field = field->message_type()->map_key();
+  const FieldDescriptor* value_field = field->message_type()->map_value();
+  const uint32_t key_tag = WireFormatLite::MakeTag(
+      1, WireTypeForFieldType(key_field->type()));
+  const uint32_t value_tag = WireFormatLite::MakeTag(
+      2, WireTypeForFieldType(value_field->type()));
+
+  MapFieldBase* map_field = reflection->MutableMapData(msg, field);
+  // Presize the map, as TcParser::MpMap() does.
+  const int num_entries = ctx->CountFieldRun(ptr, tag);
+  if (num_entries > 1) map_field->Reserve(map_field->size() + num_entries);
+
+  MapEntryFieldValue key;
+  MapEntryFieldValue value;
+  MapKey map_key;
+  while (true) {
+    key.bits = 0;
+    key.str.clear();
+    value.bits = 0;
+    value.str.clear();
+    ptr = ctx->ParseLengthDelimitedInlined(ptr, [&](const char* ptr) {
+      while (!ctx->Done(&ptr)) {
+        uint32_t inner_tag;
+        ptr = ReadTag(ptr, &inner_tag);
+        if (ptr == nullptr) return ptr;
+        if (inner_tag == key_tag) {
+          ptr = ParseMapEntryField(key_field, ptr, ctx, &key);
+        } else if (inner_tag == value_tag) {
+          ptr = ParseMapEntryField(value_field, ptr, ctx, &value);
+        } else {
+          if (inner_tag == 0 || WireFormatLite::GetTagWireType(inner_tag) ==
+                                    WireFormatLite::WIRETYPE_END_GROUP) {
+            ctx->SetLastTag(inner_tag);
+            break;
+          }
+          ptr = UnknownFieldParse(inner_tag, static_cast<std::string*>(nullptr),
+                                  ptr, ctx);
+        }
+        if (ptr == nullptr) return ptr;
+      }
+      return ptr;
+    });
+    if (ptr == nullptr) return nullptr;
+
+    // Later entries for the same key win, as with MapEntry parsing.
+    SetMapKeyFromWire(key_field, &key, &map_key);
+    MapValueRef value_ref;
+    map_field->InsertOrLookupMapValue(map_key, &value_ref);
+    SetMapValueFromWire(value_field, value, &value_ref);
+
+    if (!ctx->DataAvailable(ptr)) return ptr;
+    uint32_t next_tag;
+    const char* next = ReadTag(ptr, &next_tag);
+    if (next == nullptr || next_tag != tag) return ptr;
+    ptr = next;
+  }
+}
+
 const char* WireFormat::_InternalParseAndMergeField(
     Message* msg, const char* ptr, internal::ParseContext* ctx, uint64_t tag,
     const Reflection* reflection, const FieldDescriptor* field) {
@@ -2059,6 +2249,16 @@ const char* WireFormat::_InternalParseAndMergeField(
     }
   }
 
+  if (field->is_map()) {
+    const FieldDescriptor* value_field = field->message_type()->map_value();
+    if (value_field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE &&
+        (value_field->enum_type() == nullptr ||
+         internal::cpp::HasPreservingUnknownEnumSemantics(value_field))) {
+      return ParseMapEntries(msg, ptr, ctx, static_cast<uint32_t>(tag),
+                             reflection, field);
+    }
+  }
+
   // Non-packed value
   bool utf8_check = false;
   bool strict_utf8_check = false;
@@ -2333,49 +2533,6 @@ static uint8_t* SerializeMapValueRefWithCachedSizes(
   return target;
 }
 
-class MapKeySorter {
- public:
-  static std::vector<MapKey> SortKey(const Message& message,
-                                     const Reflection* reflection,
-                                     const FieldDescriptor* field) {
-    std::vector<MapKey> sorted_key_list;
-    for (MapIterator it =
-             reflection->MapBegin(const_cast<Message*>(&message), field);
-         it != reflection->MapEnd(const_cast<Message*>(&message), field);
-         ++it) {
-      sorted_key_list.push_back(it.GetKey());
-    }
-    MapKeyComparator comparator;
-    std::sort(sorted_key_list.begin(), sorted_key_list.end(), comparator);
-    return sorted_key_list;
-  }
-
- private:
-  class MapKeyComparator {
-   public:
-    bool operator()(const MapKey& a, const MapKey& b) const {
-      ABSL_DCHECK(a.type() == b.type());
-      switch (a.type()) {
-#define CASE_TYPE(CppType, CamelCppType)                                \
-  case FieldDescriptor::CPPTYPE_##CppType: {                            \
-    return a.Get##CamelCppType##Value() < b.Get##CamelCppType##Value(); \
-  }
-        CASE_TYPE(STRING, String)
-        CASE_TYPE(INT64, Int64)
-        CASE_TYPE(INT32, Int32)
-        CASE_TYPE(UINT64, UInt64)
-        CASE_TYPE(UINT32, UInt32)
-        CASE_TYPE(BOOL, Bool)
-#undef CASE_TYPE
-
-        default:
-          ABSL_DLOG(FATAL) << "Invalid key for map field.";
-          return true;
-      }
-    }
-  };
-};
-
 static uint8_t* InternalSerializeMapEntry(const FieldDescriptor* field,
                                           const MapKey& key,
                                           const MapValueConstRef& value,
@@ -2429,14 +2586,12 @@ uint8_t* WireFormat::InternalSerializeField(const FieldDescriptor* field,
         message_reflection->GetMapData(message, field);
     if (map_field->IsMapValid()) {
       if (stream->IsSerializationDeterministic()) {
-        std::vector<MapKey> sorted_key_list =
-            MapKeySorter::SortKey(message, message_reflection, field);
-        for (std::vector<MapKey>::iterator it = sorted_key_list.begin();
-             it != sorted_key_list.end(); ++it) {
-          MapValueConstRef map_value;
-          message_reflection->LookupMapValue(message, field, *it, &map_value);
-          target =
-              InternalSerializeMapEntry(field, *it, map_value, target, stream);
+        MapIterator it(const_cast<Message*>(&message), field);
+        NodeBase* const* sorted_nodes = map_field->SortedNodes();
+        for (int i = 0, n = map_field->size(); i < n; ++i) {
+          map_field->SetMapIteratorNode(&it, sorted_nodes[i]);
+          target = InternalSerializeMapEntry(field, it.GetKey(),
+                                             it.GetValueRef(), target, stream);
         }
       } else {
         for (MapIterator it = message_reflection->MapBegin(
@@ -1463,6 +1463,13 @@ class PROTOBUF_EXPORT WireFormat {
                                                  uint64_t tag,
                                                  const Reflection* reflection,
                                                  const FieldDescriptor* field);
+  // Parses the entries of map `field` that follow each other under `tag`
+  // straight into its map, without a MapEntry message per entry. Only for
+  // maps whose values are scalars, strings or open enums.
+  static const char* ParseMapEntries(Message* msg, const char* ptr,
+                                     internal::ParseContext* ctx, uint32_t tag,
+                                     const Reflection* reflection,
+                                     const FieldDescriptor* field);
 };
 
 // Subclass of FieldSkipper which saves skipped fields to an UnknownFieldSet.